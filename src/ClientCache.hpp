@@ -0,0 +1,42 @@
+#pragma once
+#include <unordered_map>
+
+// Something looked up per client that is expensive to find, e.g. its wayland resources. Entries are
+// rebuilt once they are outdated, and dropped by their owner when what they describe goes away.
+template <class Client, class Entry> class ClientCache {
+  public:
+    // the entry of @client, built by @build(client, entry) if there is none or @outdated(entry) says so.
+    // @build returns false if there is nothing to cache for @client, null is returned then
+    template <class Outdated, class Build> Entry* get(Client client, Outdated&& outdated, Build&& build) {
+        const auto it = this->entries.find(client);
+        if (it != this->entries.end() && !outdated(it->second)) {
+            return &it->second;
+        }
+
+        auto& entry = it != this->entries.end() ? it->second : this->entries[client];
+        entry       = Entry{};
+        if (!build(client, entry)) {
+            this->entries.erase(client);
+            return nullptr;
+        }
+
+        return &entry;
+    }
+
+    // the cached entry of @client as is, null if there is none
+    Entry* find(Client client) {
+        const auto it = this->entries.find(client);
+        return it == this->entries.end() ? nullptr : &it->second;
+    }
+
+    void drop(Client client) {
+        this->entries.erase(client);
+    }
+
+    size_t size() const {
+        return this->entries.size();
+    }
+
+  private:
+    std::unordered_map<Client, Entry> entries;
+};
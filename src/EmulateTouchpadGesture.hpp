@@ -41,6 +41,8 @@ class EmulateTouchpadGesture : public ITrackpadGesture {
             return;
         }
 
+        // every update takes the full path so hooks and pointer gesture clients see all of them. The
+        // trackpad gestures only look for a match until one of them took over
         if (ShimTrackpadGestures::isPinch(this->direction)) {
             IPointer::SPinchUpdateEvent pinch = {
                 .timeMs  = e.pinch->timeMs,
@@ -0,0 +1,85 @@
+#include "GestureBindIndex.hpp"
+
+#include <hyprland/src/debug/log/Logger.hpp>
+
+size_t SGestureBindKeyHash::operator()(const SGestureBindKey& k) const {
+    const uint64_t mods = (static_cast<uint64_t>(k.modmask) << 1) | static_cast<uint64_t>(k.locked);
+    return std::hash<uint64_t>{}(static_cast<uint64_t>(k.gesture.raw()) | (mods << 32));
+}
+
+void CGestureBindIndex::invalidate() {
+    this->dirty = true;
+}
+
+void CGestureBindIndex::refresh(const std::vector<SInternalBind>& internalBinds) {
+    if (this->dirty) {
+        this->rebuild(internalBinds);
+    }
+}
+
+std::optional<BindHandle>
+CGestureBindIndex::find(const SGestureBindKey& key, const std::vector<SInternalBind>& internalBinds) {
+    this->refresh(internalBinds);
+
+    const auto it = this->buckets.find(key);
+    if (it == this->buckets.end()) {
+        return std::nullopt;
+    }
+
+    return (static_cast<BindHandle>(this->generation) << 32) | it->second;
+}
+
+const std::vector<SP<SKeybind>>& CGestureBindIndex::get(BindHandle handle) const {
+    static const std::vector<SP<SKeybind>> EMPTY;
+
+    const auto bucket = static_cast<uint32_t>(handle);
+    if ((handle >> 32) != this->generation || bucket >= this->binds.size()) {
+        return EMPTY;
+    }
+
+    return this->binds[bucket];
+}
+
+void CGestureBindIndex::addDemand(GestureDemand& demand) const {
+    for (const auto& [key, _] : this->buckets) {
+        // edge swipe keys have no finger count, which adds any number of fingers
+        demand.add(key.gesture.type(), key.gesture.fingers());
+    }
+}
+
+void CGestureBindIndex::insert(const SGestureBindKey& key, const SP<SKeybind>& bind) {
+    const auto [it, isNew] = this->buckets.try_emplace(key, this->binds.size());
+    if (isNew) {
+        this->binds.emplace_back();
+    }
+
+    this->binds[it->second].push_back(bind);
+}
+
+void CGestureBindIndex::rebuild(const std::vector<SInternalBind>& internalBinds) {
+    this->buckets.clear();
+    this->binds.clear();
+    this->generation++;
+    this->dirty = false;
+
+    // regular binds can be gestures too, their keys are only known as strings
+    for (const auto& k : g_pKeybindManager->m_keybinds) {
+        if (k->handler == "pass")
+            continue;
+
+        const auto gesture = parseGestureKey(k->key);
+        if (!gesture)
+            continue;
+
+        this->insert({.gesture = *gesture, .modmask = k->modmask, .locked = k->locked}, k);
+    }
+
+    for (const auto& [gesture, k] : internalBinds) {
+        if (k->handler == "pass")
+            continue;
+
+        this->insert({.gesture = gesture, .modmask = k->modmask, .locked = k->locked}, k);
+    }
+
+    Log::logger->log(Log::DEBUG, "[hyprgrass] indexed {} gesture bind groups", this->binds.size());
+}
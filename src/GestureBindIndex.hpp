@@ -0,0 +1,82 @@
+#pragma once
+#include "gestures/GestureKey.hpp"
+#include "gestures/Gestures.hpp"
+
+#include <cstdint>
+#include <format>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#define private public
+#include <hyprland/src/managers/KeybindManager.hpp>
+#undef private
+
+// lets loggers take a GestureKey directly, so the string is only built if the message is actually printed
+template <>
+struct std::formatter<GestureKey> : std::formatter<std::string> {
+    auto format(const GestureKey& key, std::format_context& ctx) const {
+        return std::formatter<std::string>::format(key.to_string(), ctx);
+    }
+};
+
+// Everything a gesture bind is matched on
+struct SGestureBindKey {
+    GestureKey gesture;
+    uint32_t modmask;
+    bool locked;
+
+    bool operator==(const SGestureBindKey&) const = default;
+};
+
+struct SGestureBindKeyHash {
+    size_t operator()(const SGestureBindKey& k) const;
+};
+
+// bind defined through hyprgrass-bind/hyprgrass.bind, the gesture is parsed when the bind is defined
+struct SInternalBind {
+    GestureKey gesture;
+    SP<SKeybind> bind;
+};
+
+// Lookup table from gestures to the keybinds bound to them.
+//
+// Gesture binds live in both g_pKeybindManager->m_keybinds and our own internal binds, and are identified
+// by their key string (e.g. "swipe:3:l"). Instead of scanning both lists and comparing strings on every
+// gesture, the key strings are parsed once here and grouped by SGestureBindKey.
+//
+// The index doesn't notice changes to the keybinds by itself, it has to be invalidated whenever they may
+// have changed: on config reloads, which `hyprctl keyword` also emits, and when internal binds change.
+class CGestureBindIndex {
+  public:
+    // marks the index as outdated, it will be rebuilt on the next lookup
+    void invalidate();
+    // rebuilds the index if it is outdated
+    void refresh(const std::vector<SInternalBind>& internalBinds);
+
+    // returns a handle to the binds matching the gesture, which can be resolved with get() as long as the
+    // index is not rebuilt in between.
+    std::optional<BindHandle> find(const SGestureBindKey& key, const std::vector<SInternalBind>& internalBinds);
+
+    // binds in the same order as they were defined in; keybinds first, then internal binds.
+    // Empty if the handle is outdated
+    const std::vector<SP<SKeybind>>& get(BindHandle handle) const;
+
+    // adds every indexed gesture to @demand
+    void addDemand(GestureDemand& demand) const;
+
+    uint32_t getGeneration() const {
+        return this->generation;
+    }
+
+  private:
+    bool dirty = true;
+    // bumped on every rebuild, stored in the upper bits of a BindHandle
+    uint32_t generation = 0;
+
+    std::unordered_map<SGestureBindKey, uint32_t, SGestureBindKeyHash> buckets;
+    std::vector<std::vector<SP<SKeybind>>> binds;
+
+    void rebuild(const std::vector<SInternalBind>& internalBinds);
+    void insert(const SGestureBindKey& key, const SP<SKeybind>& bind);
+};
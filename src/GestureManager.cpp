@@ -20,7 +20,11 @@
 #undef private
 
 #include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iterator>
 #include <ranges>
+#include <type_traits>
 #include <vector>
 
 // constexpr double SWIPE_THRESHOLD = 30.;
@@ -59,18 +63,51 @@ static std::vector<std::string> splitString(const std::string& s, char delimiter
     return substrings;
 }
 
-static int handleLongPressTimer(void* data) {
+static int handleTimeoutTimer(void* data) {
+    const auto timer = (GestureManager::STimeoutTimer*)data;
+    timer->manager->onTimeout(*timer);
+
+    return 0;
+}
+
+static int handleHoldTimer(void* data) {
     const auto gesture_manager = (GestureManager*)data;
-    gesture_manager->onLongPressTimeout(gesture_manager->long_press_next_trigger_time);
+    gesture_manager->onHoldTimeout();
 
     return 0;
 }
 
+static void handleMotionFrame(void* data) {
+    const auto gesture_manager = (GestureManager*)data;
+    gesture_manager->onMotionFrame();
+}
+
+static void handleDispatchIdle(void* data) {
+    const auto gesture_manager = (GestureManager*)data;
+    gesture_manager->onDispatchIdle();
+}
+
+static Config::CCssGapData currentGapsIn() {
+    static auto PGAPSINDATA = CConfigValue<Config::IComplexConfigValue>("general:gaps_in");
+    return *static_cast<Config::CCssGapData*>(PGAPSINDATA.ptr());
+}
+
+// the gaps used while a border resize is in progress, wider so the border is easier to hit
+static Config::CCssGapData resizeGapsIn(Config::CCssGapData gapsIn) {
+    gapsIn.m_top += RESIZE_BORDER_GAP_INCREMENT;
+    gapsIn.m_right += RESIZE_BORDER_GAP_INCREMENT;
+    gapsIn.m_bottom += RESIZE_BORDER_GAP_INCREMENT;
+    gapsIn.m_left += RESIZE_BORDER_GAP_INCREMENT;
+    return gapsIn;
+}
+
 static std::string commaSeparatedCssGaps(const Config::CCssGapData& data) {
     return std::to_string(data.m_top) + "," + std::to_string(data.m_right) + "," + std::to_string(data.m_bottom) + "," +
            std::to_string(data.m_left);
 }
 
+// Sets general:gaps_in through the config manager, every workspace is laid out again with it. Hyprland has
+// no gap override scoped to a single workspace's layout that isn't itself a config rule.
 static void updateGapsIn(const Config::CCssGapData& newGapsIn) {
     static auto PGAPSINDATA = CConfigValue<Config::IComplexConfigValue>("general:gaps_in");
 
@@ -96,6 +133,114 @@ static void updateGapsIn(const Config::CCssGapData& newGapsIn) {
 }
 
 GestureManager::GestureManager() : IGestureManager(std::make_unique<HyprLogger>()) {
+    this->buildRecognizers();
+
+    this->timeoutTimer = this->makeTimeoutTimer({});
+    this->holdTimer    = wl_event_loop_add_timer(g_pCompositor->m_wlEventLoop, handleHoldTimer, this);
+}
+
+GestureManager::~GestureManager() {
+    wl_event_source_remove(this->timeoutTimer->source);
+    for (const auto& session : this->inactiveSessions) {
+        wl_event_source_remove(session.timeoutTimer->source);
+    }
+    if (this->motion_frame_idle) {
+        wl_event_source_remove(this->motion_frame_idle);
+    }
+    if (this->dispatchIdle) {
+        wl_event_source_remove(this->dispatchIdle);
+    }
+    wl_event_source_remove(this->holdTimer);
+}
+
+UP<GestureManager::STimeoutTimer> GestureManager::makeTimeoutTimer(const WP<ITouch>& device) {
+    auto timer    = makeUnique<STimeoutTimer>(STimeoutTimer{.manager = this, .device = device});
+    timer->source = wl_event_loop_add_timer(g_pCompositor->m_wlEventLoop, handleTimeoutTimer, timer.get());
+    return timer;
+}
+
+void GestureManager::activateDevice(const WP<ITouch>& device) {
+    if (this->activeDevice == device) {
+        return;
+    }
+
+    // batched motion belongs to the current device
+    this->flushMotion();
+
+    auto it = std::ranges::find_if(this->inactiveSessions, [&device](const auto& s) { return s.device == device; });
+    if (it == this->inactiveSessions.end()) {
+        this->inactiveSessions.push_back(SDeviceSession{
+            .device               = device,
+            .gestures             = this->newSession(),
+            .recognizerGeneration = this->recognizerGeneration,
+            .timeoutTimer         = this->makeTimeoutTimer(device),
+        });
+        it = std::prev(this->inactiveSessions.end());
+    }
+
+    // the recognizers were rebuilt while the device was parked, its copies may point to config values
+    // that are gone
+    if (it->recognizerGeneration != this->recognizerGeneration) {
+        this->adoptRecognizers(it->gestures);
+        it->recognizerGeneration = this->recognizerGeneration;
+    }
+
+    this->swapDeviceSession(*it);
+    it->device         = this->activeDevice;
+    this->activeDevice = device;
+
+    // the previous device is gone (or this is the first one), nothing to come back to
+    if (it->device.expired()) {
+        wl_event_source_remove(it->timeoutTimer->source);
+        this->inactiveSessions.erase(it);
+    }
+}
+
+void GestureManager::swapDeviceSession(SDeviceSession& session) {
+    this->swapSession(session.gestures);
+    std::swap(this->m_lastTouchedMonitor, session.lastTouchedMonitor);
+    std::swap(this->m_monitorArea, session.monitorArea);
+    std::swap(this->timeoutTimer, session.timeoutTimer);
+    std::swap(this->passthrough, session.passthrough);
+    std::swap(this->touchedClients, session.touchedClients);
+    std::swap(this->resizeOnBorderInfo, session.resizeOnBorderInfo);
+    std::swap(this->hitTest, session.hitTest);
+    std::swap(this->workspaceSwipeActive, session.workspaceSwipeActive);
+    std::swap(this->workspaceSwipeWarm, session.workspaceSwipeWarm);
+    std::swap(this->dragContext, session.dragContext);
+    std::swap(this->mouseBindActive, session.mouseBindActive);
+    std::swap(this->emulatedSwipePoint, session.emulatedSwipePoint);
+    std::swap(this->dragOutput, session.dragOutput);
+    std::swap(this->held, session.held);
+}
+
+WP<ITouch> GestureManager::deviceOfTouch(int32_t touchID, uint32_t time) const {
+    return this->touchDevices.resolve(touchID, time).value_or(this->activeDevice);
+}
+
+void GestureManager::listenToDevice(const SP<ITouch>& device) {
+    std::erase_if(this->deviceListeners, [](const auto& listeners) { return listeners.device.expired(); });
+    if (!device || std::ranges::any_of(this->deviceListeners, [&](const auto& l) { return l.device == device; })) {
+        return;
+    }
+
+    // the input manager gets these too and passes them on to our hooks, without the device
+    const WP<ITouch> weak = device;
+    this->deviceListeners.push_back(SDeviceListeners{
+        .device = weak,
+        .down   = device->m_touchEvents.down.listen([this, weak](ITouch::SDownEvent e) {
+            this->touchDevices.hint(weak, e.touchID, e.timeMs);
+        }),
+        .up     = device->m_touchEvents.up.listen([this, weak](ITouch::SUpEvent e) {
+            this->touchDevices.hint(weak, e.touchID, e.timeMs);
+        }),
+        .motion = device->m_touchEvents.motion.listen([this, weak](ITouch::SMotionEvent e) {
+            this->touchDevices.hint(weak, e.touchID, e.timeMs);
+        }),
+    });
+}
+
+void GestureManager::buildRecognizers() {
     static auto const PSENSITIVITY     = g_config->sensitivity;
     static auto const LONG_PRESS_DELAY = g_config->longPressDelay;
     static auto const EDGE_MARGIN      = g_config->edgeMargin;
@@ -103,37 +248,53 @@ GestureManager::GestureManager() : IGestureManager(std::make_unique<HyprLogger>(
     const auto longPressDelay          = LONG_PRESS_DELAY->m_val.ptr();
     const auto margin                  = EDGE_MARGIN->m_val.ptr();
 
+    this->clearRecognizers();
+    this->recognizerGeneration++;
     this->addEdgeSwipeGesture(SWIPE_THRESHOLD, SWIPE_INCORRECT_DRAG_TOLERANCE, sensitivity, longPressDelay, margin);
     // TODO: should I use SWIPE_INCORRECT_DRAG_TOLERANCE instead?
     this->addLongPress(SWIPE_THRESHOLD, sensitivity, longPressDelay);
     this->addMultiFingerGesture(SWIPE_THRESHOLD, SWIPE_INCORRECT_DRAG_TOLERANCE, sensitivity, longPressDelay);
     this->addMultiFingerTap(SWIPE_INCORRECT_DRAG_TOLERANCE, sensitivity, longPressDelay);
     this->addPinchGesture(PINCH_THRESHOLD, sensitivity, longPressDelay);
-
-    this->long_press_timer = wl_event_loop_add_timer(g_pCompositor->m_wlEventLoop, handleLongPressTimer, this);
 }
 
-GestureManager::~GestureManager() {
-    wl_event_source_remove(this->long_press_timer);
+std::optional<BindHandle> GestureManager::findCompletedGesture(const CompletedGestureEvent& gev) const {
+    const auto MODS   = g_pInputManager->getModsFromAllKBs();
+    const bool LOCKED = g_pSessionLockManager->isSessionLocked();
+    return this->findGestureBind({.gesture = GestureKey::from(gev), .modmask = MODS, .locked = LOCKED});
 }
 
-bool GestureManager::findCompletedGesture(const CompletedGestureEvent& gev) const {
-    return this->findGestureBind(gev.to_string(), GestureEventType::COMPLETED);
+bool GestureManager::handleCompletedGesture(const CompletedGestureEvent& gev, std::optional<BindHandle> binds) {
+    if (!binds) {
+        binds = this->findCompletedGesture(gev);
+    }
+
+    return binds && this->handleGestureBind(*binds, GestureEventType::COMPLETED);
 }
-bool GestureManager::handleCompletedGesture(const CompletedGestureEvent& gev) {
-    return this->handleGestureBind(gev.to_string(), GestureEventType::COMPLETED);
+
+bool GestureManager::handleDragGestureBind(const DragGestureEvent& gev, GestureEventType type) {
+    const auto MODS   = g_pInputManager->getModsFromAllKBs();
+    const bool LOCKED = g_pSessionLockManager->isSessionLocked();
+    const auto binds  = this->findGestureBind({.gesture = GestureKey::from(gev), .modmask = MODS, .locked = LOCKED});
+
+    return binds && this->handleGestureBind(*binds, type);
 }
 
 bool GestureManager::handleDragGesture(const DragGestureEvent& gev) {
+    const bool handled = this->startDragGesture(gev);
+    // a warmed up workspace swipe is committed by handleWorkspaceSwipe, otherwise another gesture won
+    this->discardWorkspaceSwipeWarmup();
+    return handled;
+}
+
+bool GestureManager::startDragGesture(const DragGestureEvent& gev) {
     static auto const WORKSPACE_SWIPE_FINGERS = g_config->workspaceSwipeFingers;
     static auto const WORKSPACE_SWIPE_EDGE    = g_config->workspaceSwipeEdge;
     static auto const RESIZE_LONG_PRESS       = g_config->resizeOnBorder;
 
-    static auto PBORDERSIZE       = CConfigValue<Config::INTEGER>("general:border_size");
-    static auto PBORDERGRABEXTEND = CConfigValue<Config::INTEGER>("general:extend_border_grab_area");
-    static auto PGAPSINDATA       = CConfigValue<Config::IComplexConfigValue>("general:gaps_in");
+    Log::logger->log(Log::DEBUG, "[hyprgrass] Drag gesture begin: {}", GestureKey::from(gev));
 
-    Log::logger->log(Log::DEBUG, "[hyprgrass] Drag gesture begin: {}", gev.to_string());
+    this->beginDragContext();
 
     auto const workspace_swipe_edge_str = WORKSPACE_SWIPE_EDGE->value();
 
@@ -174,66 +335,40 @@ bool GestureManager::handleDragGesture(const DragGestureEvent& gev) {
 
         case GestureType::LONG_PRESS:
             if (g_pSessionLockManager->isSessionLocked()) {
-                return this->handleGestureBind(gev.to_string(), GestureEventType::DRAG_BEGIN);
+                return this->handleDragGestureBind(gev, GestureEventType::DRAG_BEGIN);
             }
 
             if (RESIZE_LONG_PRESS->value() && gev.finger_count == 1) {
-                const auto BORDER_GRAB_AREA = *PBORDERSIZE + *PBORDERGRABEXTEND;
-
-                // kind of a hack: this is the window detected from previous touch events
-                const auto w = g_pInputManager->m_foundWindowToFocus.lock();
-                const Vector2D touchPos =
-                    pixelPositionToPercentagePosition(this->m_sGestureState.get_center().current) *
-                    this->m_lastTouchedMonitor->m_size;
-                if (w && !w->isFullscreen()) {
-                    const CBox real = {
-                        w->m_realPosition->value().x, w->m_realPosition->value().y, w->m_realSize->value().x,
-                        w->m_realSize->value().y
+                const auto w = this->hitTest.window.lock();
+                if (w && !this->hitTest.fullscreen && this->hitTest.onBorder && !this->hitTest.popup) {
+                    IPointer::SButtonEvent e = {
+                        .timeMs = 0, // HACK: they don't use this :p
+                        .button = 0,
+                        .state  = WL_POINTER_BUTTON_STATE_PRESSED,
                     };
-                    const CBox grab = {
-                        real.x - BORDER_GRAB_AREA, real.y - BORDER_GRAB_AREA, real.width + 2 * BORDER_GRAB_AREA,
-                        real.height + 2 * BORDER_GRAB_AREA
+                    g_pKeybindManager->resizeWithBorder(e);
+
+                    const auto oldGapsIn     = currentGapsIn();
+                    this->resizeOnBorderInfo = {
+                        .active      = true,
+                        .old_gaps_in = oldGapsIn,
                     };
 
-                    bool notInRealWindow = !real.containsPoint(touchPos) || w->isInCurvedCorner(touchPos.x, touchPos.y);
-                    bool onTiledGap      = !w->m_isFloating && !w->isFullscreen() && notInRealWindow;
-                    bool inGrabArea      = notInRealWindow && grab.containsPoint(touchPos);
-
-                    if ((onTiledGap || inGrabArea) && !w->hasPopupAt(touchPos)) {
-                        IPointer::SButtonEvent e = {
-                            .timeMs = 0, // HACK: they don't use this :p
-                            .button = 0,
-                            .state  = WL_POINTER_BUTTON_STATE_PRESSED,
-                        };
-                        g_pKeybindManager->resizeWithBorder(e);
-
-                        auto oldGapsIn           = *static_cast<Config::CCssGapData*>(PGAPSINDATA.ptr());
-                        this->resizeOnBorderInfo = {
-                            .active      = true,
-                            .old_gaps_in = oldGapsIn,
-                        };
-
-                        Config::CCssGapData newGapsIn = oldGapsIn;
-                        newGapsIn.m_top += RESIZE_BORDER_GAP_INCREMENT;
-                        newGapsIn.m_right += RESIZE_BORDER_GAP_INCREMENT;
-                        newGapsIn.m_bottom += RESIZE_BORDER_GAP_INCREMENT;
-                        newGapsIn.m_left += RESIZE_BORDER_GAP_INCREMENT;
-                        updateGapsIn(newGapsIn);
-                        return true;
-                    }
+                    updateGapsIn(resizeGapsIn(oldGapsIn));
+                    return true;
                 }
             }
 
             if (this->trackpadGestureBegin(gev))
                 return true;
 
-            return this->handleGestureBind(gev.to_string(), GestureEventType::DRAG_BEGIN);
+            return this->handleDragGestureBind(gev, GestureEventType::DRAG_BEGIN);
 
         case GestureType::PINCH:
             if (this->trackpadGestureBegin(gev))
                 return true;
 
-            return this->handleGestureBind(gev.to_string(), GestureEventType::DRAG_BEGIN);
+            return this->handleDragGestureBind(gev, GestureEventType::DRAG_BEGIN);
             break;
         case GestureType::TAP:
             // tap does not trigger drag
@@ -243,52 +378,16 @@ bool GestureManager::handleDragGesture(const DragGestureEvent& gev) {
     return false;
 }
 
-bool GestureManager::findGestureBind(std::string bind, GestureEventType type) const {
-    Log::logger->log(Log::DEBUG, "[hyprgrass] Looking for binds matching: {}", bind);
-
-    auto allBinds   = std::ranges::views::join(std::array{g_pKeybindManager->m_keybinds, this->internalBinds});
-    const auto MODS = g_pInputManager->getModsFromAllKBs();
-
-    for (const auto& k : allBinds) {
-        if (k->key != bind)
-            continue;
-
-        if (k->handler == "pass")
-            continue;
-
-        if (k->locked != g_pSessionLockManager->isSessionLocked())
-            continue;
-
-        if (k->modmask != MODS)
-            continue;
-
-        return true;
-    }
-    return false;
+std::optional<BindHandle> GestureManager::findGestureBind(const SGestureBindKey& key) const {
+    return this->bindIndex.find(key, this->internalBinds);
 }
 
-// bind is the name of the gesture event.
+// binds is a handle to binds that already match the gesture, modifiers and lock state.
 // pressed only matters for mouse binds: only start of drag gestures should set it to true
-bool GestureManager::handleGestureBind(std::string bind, GestureEventType type) {
+bool GestureManager::handleGestureBind(BindHandle binds, GestureEventType type) {
     bool found = false;
-    Log::logger->log(Log::DEBUG, "[hyprgrass] Looking for binds matching: {}", bind);
-
-    auto allBinds   = std::ranges::views::join(std::array{g_pKeybindManager->m_keybinds, this->internalBinds});
-    const auto MODS = g_pInputManager->getModsFromAllKBs();
-
-    for (const auto& k : allBinds) {
-        if (k->key != bind)
-            continue;
-
-        if (k->handler == "pass")
-            continue;
-
-        if (k->locked != g_pSessionLockManager->isSessionLocked())
-            continue;
-
-        if (k->modmask != MODS)
-            continue;
 
+    for (const auto& k : this->bindIndex.get(binds)) {
         // only legacy config uses "mouse" dispatcher
         bool useMouseDispatcher = k->mouse && Config::mgr()->type() == Config::CONFIG_LEGACY;
         const auto DISPATCHER   = g_pKeybindManager->m_dispatchers.find(useMouseDispatcher ? "mouse" : k->handler);
@@ -303,8 +402,7 @@ bool GestureManager::handleGestureBind(std::string bind, GestureEventType type)
             case GestureEventType::COMPLETED:
                 // mouse dispatchers only trigger on drag begin/end
                 if (!k->mouse) {
-                    Log::logger->log(Log::DEBUG, "[hyprgrass] calling dispatcher ({})", bind);
-                    DISPATCHER->second(k->arg);
+                    this->queueDispatch(k);
                     found = found || !k->nonConsuming;
                 }
                 break;
@@ -315,8 +413,12 @@ bool GestureManager::handleGestureBind(std::string bind, GestureEventType type)
                     continue;
                 }
 
+                // mouse binds track the drag as it happens and can't be deferred, binds of gestures that
+                // completed earlier must not run after them though
+                this->flushDispatchQueue();
+
                 if (useMouseDispatcher) {
-                    Log::logger->log(Log::DEBUG, "[hyprgrass] calling mouse dispatcher ({})", bind);
+                    Log::logger->log(Log::DEBUG, "[hyprgrass] calling mouse dispatcher ({})", k->key);
                     char pressed = type == GestureEventType::DRAG_BEGIN ? '1' : '0';
                     DISPATCHER->second(pressed + k->arg);
                     found = found || !k->nonConsuming;
@@ -338,6 +440,48 @@ bool GestureManager::handleGestureBind(std::string bind, GestureEventType type)
     return found;
 }
 
+void GestureManager::queueDispatch(const SP<SKeybind>& bind) {
+    this->dispatchQueue.push_back({.bind = bind, .queuedAt = std::chrono::steady_clock::now()});
+    if (!this->dispatchIdle) {
+        this->dispatchIdle = wl_event_loop_add_idle(g_pCompositor->m_wlEventLoop, handleDispatchIdle, this);
+    }
+}
+
+void GestureManager::onDispatchIdle() {
+    // idle sources are removed by the event loop after they fire
+    this->dispatchIdle = nullptr;
+    this->flushDispatchQueue();
+}
+
+void GestureManager::flushDispatchQueue() {
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+
+    // a dispatcher can complete another gesture, e.g. by simulating input, its binds run after these
+    auto queue = std::move(this->dispatchQueue);
+    this->dispatchQueue.clear();
+
+    for (const auto& [k, queuedAt] : queue) {
+        const auto DISPATCHER = g_pKeybindManager->m_dispatchers.find(k->handler);
+        // the config may have been reloaded since the gesture completed
+        if (DISPATCHER == g_pKeybindManager->m_dispatchers.end()) {
+            Log::logger->log(Log::ERR, "Invalid handler in a keybind! (handler {} does not exist)", k->handler);
+            continue;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        DISPATCHER->second(k->arg);
+        const auto end = std::chrono::steady_clock::now();
+
+        const auto waited = duration_cast<microseconds>(start - queuedAt).count();
+        const auto took   = duration_cast<microseconds>(end - start).count();
+        Log::logger->log(
+            end - start > SLOW_DISPATCH ? Log::WARN : Log::DEBUG,
+            "[hyprgrass] dispatcher ({}) ran for {}us after waiting {}us", k->key, took, waited
+        );
+    }
+}
+
 void GestureManager::handleCancelledGesture() {}
 
 void GestureManager::dragGestureUpdate(const wf::touch::gesture_event_t& ev) {
@@ -345,8 +489,52 @@ void GestureManager::dragGestureUpdate(const wf::touch::gesture_event_t& ev) {
         return;
     }
 
-    if (this->activeTrackpadGesture) {
-        this->trackpadGestureUpdate(ev.time);
+    // touch panels usually report faster than the monitor refreshes, only the last update
+    // before a frame is ever visible. Everything below reads the latest touch metrics
+    // so skipping intermediate updates loses nothing.
+    this->dragOutput.time = ev.time;
+    if (!this->dragOutput.pending) {
+        this->dragOutput.pending = true;
+        this->dragOutput.monitor = this->m_lastTouchedMonitor;
+        g_pCompositor->scheduleFrameForMonitor(this->m_lastTouchedMonitor);
+    }
+}
+
+void GestureManager::onPreRender(PHLMONITOR monitor) {
+    const auto pendingHere = [&monitor](const SDragOutput& output) {
+        return output.pending && output.monitor.lock() == monitor;
+    };
+
+    if (pendingHere(this->dragOutput)) {
+        this->flushDragOutput();
+    }
+
+    // other devices dragging on the same monitor, rare enough to just switch to each of them
+    while (true) {
+        const auto it = std::ranges::find_if(this->inactiveSessions, [&](const auto& s) {
+            return pendingHere(s.dragOutput);
+        });
+        if (it == this->inactiveSessions.end()) {
+            break;
+        }
+
+        this->activateDevice(WP<ITouch>{it->device});
+        this->flushDragOutput();
+    }
+}
+
+void GestureManager::flushDragOutput() {
+    if (!this->dragOutput.pending) {
+        return;
+    }
+    this->dragOutput.pending = false;
+
+    if (!this->getActiveDragGesture().has_value()) {
+        return;
+    }
+
+    if (this->dragContext.handler) {
+        this->trackpadGestureUpdate(this->dragOutput.time);
         return;
     }
 
@@ -358,7 +546,7 @@ void GestureManager::dragGestureUpdate(const wf::touch::gesture_event_t& ev) {
             return;
 
         case GestureType::LONG_PRESS: {
-            const auto pos = this->m_sGestureState.get_center().current;
+            const auto pos = this->touchMetrics().center().current;
             g_pCompositor->warpCursorTo(Vector2D(pos.x, pos.y));
             g_pInputManager->simulateMouseMovement();
             return;
@@ -376,20 +564,24 @@ void GestureManager::dragGestureUpdate(const wf::touch::gesture_event_t& ev) {
 }
 
 void GestureManager::handleDragGestureEnd(const DragGestureEvent& gev) {
+    // the end must not overtake the last update
+    this->flushDragOutput();
+
     if (g_pSessionLockManager->isSessionLocked()) {
-        this->handleGestureBind(gev.to_string(), GestureEventType::DRAG_END);
+        this->handleDragGestureBind(gev, GestureEventType::DRAG_END);
         return;
     }
 
-    if (this->activeTrackpadGesture) {
+    if (this->dragContext.handler) {
         this->trackpadGestureEnd(gev.time);
         return;
     }
 
-    Log::logger->log(Log::DEBUG, "[hyprgrass] Drag gesture ended: {}", gev.to_string());
+    Log::logger->log(Log::DEBUG, "[hyprgrass] Drag gesture ended: {}", GestureKey::from(gev));
     switch (gev.type) {
         case GestureType::SWIPE:
             if (this->workspaceSwipeActive) {
+                this->flingWorkspaceSwipe();
                 g_pUnifiedWorkspaceSwipe->end();
                 this->workspaceSwipeActive = false;
             }
@@ -404,17 +596,19 @@ void GestureManager::handleDragGestureEnd(const DragGestureEvent& gev) {
 
             // longpress already triggered CompletedGesture on timeout
             if (this->mouseBindActive) {
-                this->handleGestureBind(gev.to_string(), GestureEventType::DRAG_END);
+                this->handleDragGestureBind(gev, GestureEventType::DRAG_END);
             }
 
             return;
         case GestureType::EDGE_SWIPE:
             if (this->workspaceSwipeActive) {
+                this->flingWorkspaceSwipe();
                 g_pUnifiedWorkspaceSwipe->end();
+                this->workspaceSwipeActive = false;
             }
             break;
         case GestureType::PINCH:
-            this->handleGestureBind(gev.to_string(), GestureEventType::DRAG_END);
+            this->handleDragGestureBind(gev, GestureEventType::DRAG_END);
             return;
         case GestureType::TAP:
             // tap does not trigger drag
@@ -422,55 +616,232 @@ void GestureManager::handleDragGestureEnd(const DragGestureEvent& gev) {
     }
 }
 
-bool GestureManager::handleWorkspaceSwipe(const GestureDirection direction) {
-    const bool VERTANIMS =
-        Desktop::focusState()->monitor()->m_activeWorkspace->m_renderOffset->getConfig()->pValues->internalStyle ==
-            "slidevert" ||
-        Desktop::focusState()
-            ->monitor()
-            ->m_activeWorkspace->m_renderOffset->getConfig()
-            ->pValues->internalStyle.starts_with("slidevert");
+GestureManager::SHitTest GestureManager::hitTestWindow(wf::touch::point_t touchPos) const {
+    static auto PBORDERSIZE       = CConfigValue<Config::INTEGER>("general:border_size");
+    static auto PBORDERGRABEXTEND = CConfigValue<Config::INTEGER>("general:extend_border_grab_area");
+
+    const Vector2D pos = {touchPos.x, touchPos.y};
+    // same lookup refocus() does for the cursor
+    const auto w = g_pCompositor->vectorToWindowUnified(pos, RESERVED_EXTENTS | INPUT_EXTENTS | ALLOW_FLOATING);
+    if (!w) {
+        return {};
+    }
+
+    const auto BORDER_GRAB_AREA = *PBORDERSIZE + *PBORDERGRABEXTEND;
 
+    const CBox real = {
+        w->m_realPosition->value().x, w->m_realPosition->value().y, w->m_realSize->value().x, w->m_realSize->value().y
+    };
+
+    SHitTest hit = {
+        .window = w,
+        .real   = real,
+        .grab   = {
+            real.x - BORDER_GRAB_AREA, real.y - BORDER_GRAB_AREA, real.width + 2 * BORDER_GRAB_AREA,
+            real.height + 2 * BORDER_GRAB_AREA
+        },
+        .floating   = w->m_isFloating,
+        .fullscreen = w->isFullscreen(),
+        .popup      = w->hasPopupAt(pos),
+    };
+
+    const bool notInRealWindow = !hit.real.containsPoint(pos) || w->isInCurvedCorner(pos.x, pos.y);
+    const bool onTiledGap      = !hit.floating && !hit.fullscreen && notInRealWindow;
+    const bool inGrabArea      = notInRealWindow && hit.grab.containsPoint(pos);
+    hit.onBorder               = onTiledGap || inGrabArea;
+
+    return hit;
+}
+
+void GestureManager::beginDragContext() {
+    static auto const PSWIPEDIST = CConfigValue<Config::INTEGER>("gestures:workspace_swipe_distance");
+
+    const auto monitor = Desktop::focusState()->monitor();
+    const auto style   = monitor && monitor->m_activeWorkspace
+                             ? monitor->m_activeWorkspace->m_renderOffset->getStyle()
+                             : std::string{};
+
+    this->dragContext = {
+        .monitorArea   = this->getMonitorArea(),
+        .swipeDistance = (double)std::clamp(*PSWIPEDIST, (int64_t)1LL, (int64_t)UINT32_MAX),
+        // same check as the workspace swipe of hyprland, the swipe begins on this workspace
+        .verticalAnims = style == "slidevert" || style.starts_with("slidefadevert"),
+    };
+}
+
+bool GestureManager::handleWorkspaceSwipe(const GestureDirection direction) {
     const auto horizontal           = GESTURE_DIRECTION_LEFT | GESTURE_DIRECTION_RIGHT;
     const auto vertical             = GESTURE_DIRECTION_UP | GESTURE_DIRECTION_DOWN;
-    const auto workspace_directions = VERTANIMS ? vertical : horizontal;
-    const auto anti_directions      = VERTANIMS ? horizontal : vertical;
+    const auto workspace_directions = this->dragContext.verticalAnims ? vertical : horizontal;
+    const auto anti_directions      = this->dragContext.verticalAnims ? horizontal : vertical;
+
+    if (!(direction & workspace_directions) || direction & anti_directions) {
+        return false;
+    }
 
-    if (direction & workspace_directions && !(direction & anti_directions)) {
-        this->workspaceSwipeActive = true;
+    if (this->workspaceSwipeWarm) {
+        this->workspaceSwipeWarm = false;
+    } else if (g_pUnifiedWorkspaceSwipe->isGestureInProgress()) {
+        // there is a single workspace swipe, owned by another touch device (or the trackpad)
+        return false;
+    } else {
         g_pUnifiedWorkspaceSwipe->begin();
-        return true;
     }
 
-    return false;
+    this->workspaceSwipeActive = true;
+    return true;
+}
+
+static GestureDirection edgeFromString(const std::string& edge) {
+    if (edge == "l") {
+        return GESTURE_DIRECTION_LEFT;
+    }
+    if (edge == "r") {
+        return GESTURE_DIRECTION_RIGHT;
+    }
+    if (edge == "u") {
+        return GESTURE_DIRECTION_UP;
+    }
+    if (edge == "d") {
+        return GESTURE_DIRECTION_DOWN;
+    }
+    return 0;
+}
+
+void GestureManager::warmUpWorkspaceSwipe(wf::touch::point_t touchPos) {
+    static auto const WARMUP                  = g_config->workspaceSwipeWarmup;
+    static auto const WORKSPACE_SWIPE_FINGERS = g_config->workspaceSwipeFingers;
+    static auto const WORKSPACE_SWIPE_EDGE    = g_config->workspaceSwipeEdge;
+    static auto const EDGE_MARGIN             = g_config->edgeMargin;
+
+    if (!WARMUP->value() || this->getActiveDragGesture().has_value()) {
+        return;
+    }
+
+    const auto fingers    = static_cast<int64_t>(this->m_sGestureState.size());
+    const auto edge       = edgeFromString(WORKSPACE_SWIPE_EDGE->value());
+    const bool fromEdge   = fingers == 1 && (this->find_swipe_edges(touchPos, EDGE_MARGIN->value()) & edge);
+    const bool couldSwipe =
+        (fingers == WORKSPACE_SWIPE_FINGERS->value() && this->hasLiveGesture(GestureType::SWIPE)) ||
+        (fromEdge && this->hasLiveGesture(GestureType::EDGE_SWIPE));
+
+    if (!couldSwipe) {
+        // e.g. one finger too many for the workspace swipe
+        this->discardWorkspaceSwipeWarmup();
+        return;
+    }
+
+    if (this->workspaceSwipeWarm || g_pUnifiedWorkspaceSwipe->isGestureInProgress()) {
+        return;
+    }
+
+    // the first frames of the swipe no longer have to set up the neighbouring workspaces
+    g_pUnifiedWorkspaceSwipe->begin();
+    this->workspaceSwipeWarm = true;
+}
+
+void GestureManager::discardWorkspaceSwipeWarmup() {
+    if (!this->workspaceSwipeWarm) {
+        return;
+    }
+
+    // nothing moved yet, so this just settles back on the current workspace
+    this->workspaceSwipeWarm = false;
+    g_pUnifiedWorkspaceSwipe->end();
+}
+
+void GestureManager::settleWorkspaceSwipeWarmup() {
+    if (!this->workspaceSwipeWarm || this->getActiveDragGesture().has_value()) {
+        return;
+    }
+
+    // e.g. the fingers rest until the swipe times out, they may stay down for a long time after
+    if (!this->hasLiveGesture(GestureType::SWIPE) && !this->hasLiveGesture(GestureType::EDGE_SWIPE)) {
+        this->discardWorkspaceSwipeWarmup();
+    }
 }
 
 void GestureManager::updateWorkspaceSwipe() {
-    const auto ANIMSTYLE   = g_pUnifiedWorkspaceSwipe->m_workspaceBegin->m_renderOffset->getStyle();
-    const bool VERTANIMS   = ANIMSTYLE == "slidevert" || ANIMSTYLE.starts_with("slidefadevert");
-    const auto swipe_delta = this->pixelToTrackpadDistance(this->m_sGestureState.get_center().delta());
+    const auto swipe_delta = this->pixelToTrackpadDistance(this->touchMetrics().center().delta());
 
-    g_pUnifiedWorkspaceSwipe->update(VERTANIMS ? -swipe_delta.y : -swipe_delta.x);
+    g_pUnifiedWorkspaceSwipe->update(this->dragContext.verticalAnims ? -swipe_delta.y : -swipe_delta.x);
     return;
 }
 
+// Hyprland can't be given a release velocity, its workspace swipe decides on end() by the distance and by
+// its private m_avgSpeed, reached through `#define private public`. The fling moves the swipe to the matching
+// side of the cancel ratio and resets m_avgSpeed when flung back. Only that decision follows the velocity,
+// the animation after the release is hyprland's own.
+void GestureManager::flingWorkspaceSwipe() {
+    static auto const FLING_VELOCITY = g_config->workspaceSwipeFlingVelocity;
+    static auto const PCANCELRATIO   = CConfigValue<Config::FLOAT>("gestures:workspace_swipe_cancel_ratio");
+
+    if (FLING_VELOCITY->value() <= 0) {
+        return;
+    }
+
+    // same sign as the distances given to the swipe in updateWorkspaceSwipe
+    const auto velocity = this->touchHistory().centerVelocity();
+    const double speed  = this->dragContext.verticalAnims ? -velocity.y : -velocity.x;
+    const double delta  = g_pUnifiedWorkspaceSwipe->m_delta;
+    if (std::abs(speed) < FLING_VELOCITY->value() || delta == 0) {
+        return;
+    }
+
+    // hyprland switches workspaces if the swipe went further than this when it ends
+    const double cancelAt = this->dragContext.swipeDistance * std::clamp((double)*PCANCELRATIO, 0.0, 1.0);
+    const double towards  = delta > 0 ? 1.0 : -1.0;
+
+    // update() takes the distance from where the swipe started
+    if ((speed > 0) == (delta > 0)) {
+        // whatever is left of the way to the next workspace is animated from here
+        if (std::abs(delta) <= cancelAt) {
+            g_pUnifiedWorkspaceSwipe->update(towards * (cancelAt + 1));
+        }
+    } else {
+        // flung back, it must not be switched by its average speed either
+        if (std::abs(delta) >= cancelAt) {
+            g_pUnifiedWorkspaceSwipe->update(towards * std::max(cancelAt - 1, 0.0));
+        }
+        g_pUnifiedWorkspaceSwipe->m_avgSpeed = 0;
+    }
+
+    Log::logger->log(Log::DEBUG, "[hyprgrass] Workspace swipe flung at {:.0f}px/s", speed);
+}
+
 bool GestureManager::trackpadGestureBegin(const DragGestureEvent& gev) {
-    Vector2D delta = this->pixelToTrackpadDistance(this->m_sGestureState.get_center().delta());
+    Vector2D delta = this->pixelToTrackpadDistance(this->touchMetrics().center().delta());
 
-    // longpress events do not trigger a handler->m_activeGesture at the beginning,
-    // we look it up ourselves beforehand
-    bool foundLongPress = false;
+    const uint32_t fingers = gev.type == GestureType::EDGE_SWIPE ? gev.edge_origin : gev.finger_count;
+
+    const auto MODS  = g_pInputManager->getModsFromAllKBs();
+    const auto bound = g_pShimTrackpadGestures->findDirections(gev.type, fingers, MODS);
+    if (!bound) {
+        return false;
+    }
+
+    // mirror how the handler picks a gesture on its first update, so it's only fed events it will take.
     // hyprland has an arbitrary threshold of 5 pixels
-    if (gev.type == GestureType::LONG_PRESS && std::abs(delta.x) < 5 && std::abs(delta.y) < 5) {
-        const auto MODS = g_pInputManager->getModsFromAllKBs();
-        for (const auto& g : g_pShimTrackpadGestures->longPress()->m_gestures) {
-            if (g->fingerCount == gev.finger_count && g->modMask == MODS) {
-                foundLongPress = true;
-                break;
-            }
+    const bool moved = std::abs(delta.x) >= 5 || std::abs(delta.y) >= 5;
+    // longpress events do not trigger a handler->m_activeGesture at the beginning,
+    // any direction is fine as long as the fingers didn't move yet
+    const bool foundLongPress = gev.type == GestureType::LONG_PRESS && !moved;
+    if (gev.type == GestureType::PINCH) {
+        if (!(*bound & gev.direction)) {
+            return false;
+        }
+    } else if (!foundLongPress) {
+        if (!moved) {
+            return false;
+        }
+
+        const GestureDirection direction = std::abs(delta.x) > std::abs(delta.y)
+                                               ? (delta.x < 0 ? GESTURE_DIRECTION_LEFT : GESTURE_DIRECTION_RIGHT)
+                                               : (delta.y < 0 ? GESTURE_DIRECTION_UP : GESTURE_DIRECTION_DOWN);
+        if (!(*bound & direction)) {
+            return false;
         }
     }
-    uint32_t fingers = gev.type == GestureType::EDGE_SWIPE ? gev.edge_origin : gev.finger_count;
 
     CTrackpadGestures* handler = g_pShimTrackpadGestures->get(gev.type);
     if (gev.type == GestureType::PINCH) {
@@ -482,8 +853,8 @@ bool GestureManager::trackpadGestureBegin(const DragGestureEvent& gev) {
             .timeMs   = gev.time,
             .fingers  = fingers,
             .delta    = delta,
-            .scale    = this->m_sGestureState.get_pinch_scale(),
-            .rotation = this->m_sGestureState.get_rotation_angle(),
+            .scale    = this->touchMetrics().pinchScale(),
+            .rotation = this->touchMetrics().rotation(),
         };
 
         handler->gestureBegin(pinchBegin);
@@ -499,40 +870,38 @@ bool GestureManager::trackpadGestureBegin(const DragGestureEvent& gev) {
             .delta   = delta,
         };
 
-        CTrackpadGestures* handler = g_pShimTrackpadGestures->get(gev.type);
         handler->gestureBegin(swipeBegin);
         handler->gestureUpdate(swipe);
     }
-    this->emulatedSwipePoint = this->m_sGestureState.get_center().current;
+    this->emulatedSwipePoint = this->touchMetrics().center().current;
 
-    this->activeTrackpadGesture = foundLongPress || handler->m_activeGesture ? handler : nullptr;
-    return this->activeTrackpadGesture;
+    this->dragContext.handler = foundLongPress || handler->m_activeGesture ? handler : nullptr;
+    this->dragContext.fingers = fingers;
+    return this->dragContext.handler;
 }
 
 void GestureManager::trackpadGestureUpdate(uint32_t time) {
-    if (!this->activeTrackpadGesture)
+    if (!this->dragContext.handler)
         return;
 
-    const auto currentPoint = this->m_sGestureState.get_center().current;
+    const auto currentPoint = this->touchMetrics().center().current;
     const auto deltaPx      = currentPoint - this->emulatedSwipePoint;
     const Vector2D delta    = pixelToTrackpadDistance(deltaPx);
-
-    DragGestureEvent activeDrag = this->getActiveDragGesture().value();
-    uint32_t fingers = activeDrag.type == GestureType::EDGE_SWIPE ? activeDrag.edge_origin : activeDrag.finger_count;
+    const uint32_t fingers  = this->dragContext.fingers;
 
     this->emulatedSwipePoint = currentPoint;
 
-    if (activeDrag.type == GestureType::PINCH) {
+    if (this->getActiveDragGesture()->type == GestureType::PINCH) {
         IPointer::SPinchUpdateEvent pinch = {
             .timeMs  = time,
             .fingers = fingers,
             .delta   = delta,
-            .scale   = this->m_sGestureState.get_pinch_scale(),
+            .scale   = this->touchMetrics().pinchScale(),
             // FIXME: rotation should be relative to previous update event, not the initial one
-            .rotation = this->m_sGestureState.get_rotation_angle(),
+            .rotation = this->touchMetrics().rotation(),
         };
 
-        this->activeTrackpadGesture->gestureUpdate(pinch);
+        this->dragContext.handler->gestureUpdate(pinch);
     } else {
         IPointer::SSwipeUpdateEvent swipe = {
             .timeMs  = time,
@@ -540,7 +909,7 @@ void GestureManager::trackpadGestureUpdate(uint32_t time) {
             .delta   = delta,
         };
 
-        this->activeTrackpadGesture->gestureUpdate(swipe);
+        this->dragContext.handler->gestureUpdate(swipe);
     }
 }
 
@@ -551,45 +920,157 @@ void GestureManager::trackpadGestureEnd(uint32_t time) {
             .timeMs    = time,
             .cancelled = false,
         };
-        this->activeTrackpadGesture->gestureEnd(swipe);
+        this->dragContext.handler->gestureEnd(swipe);
     } else {
         IPointer::SSwipeEndEvent swipe = {
             .timeMs    = time,
             .cancelled = false,
         };
-        this->activeTrackpadGesture->gestureEnd(swipe);
+        this->dragContext.handler->gestureEnd(swipe);
     }
-    this->activeTrackpadGesture = nullptr;
+    this->dragContext.handler = nullptr;
 }
 
-void GestureManager::updateLongPressTimer(uint32_t current_time, uint32_t delay) {
-    this->long_press_next_trigger_time = current_time + delay + 1;
-    wl_event_source_timer_update(this->long_press_timer, delay);
-}
+void GestureManager::updateTimeoutTimer(uint32_t current_time, std::optional<uint32_t> deadline) {
+    if (!deadline) {
+        wl_event_source_timer_update(this->timeoutTimer->source, 0);
+        return;
+    }
 
-void GestureManager::stopLongPressTimer() {
-    wl_event_source_timer_update(this->long_press_timer, 0);
+    this->timeoutTimer->deadline = *deadline;
+    // 0 would disarm the timer, a deadline that already passed fires right away
+    const auto delay = std::max<int32_t>(static_cast<int32_t>(*deadline - current_time), 1);
+    wl_event_source_timer_update(this->timeoutTimer->source, delay);
 }
 
 void GestureManager::sendCancelEventsToWindows() {
     static auto const SEND_CANCEL = g_config->sendCancel;
 
+    // windows never saw these, so there is nothing to cancel
+    this->dropHeldTouches();
+
     if (!SEND_CANCEL->value()) {
         return;
     }
 
-    for (const auto& touch : this->touchedResources.all()) {
-        const auto t = touch.lock();
-        if (t.get()) {
-            t->sendCancel();
+    for (wl_client* client : this->touchedClients.all()) {
+        // also picks up a wl_touch bound since the client was touched
+        const auto* touches = this->touchesOfClient(client);
+        if (!touches) {
+            continue;
+        }
+
+        for (const auto& touch : touches->touches) {
+            const auto t = touch.lock();
+            if (t.get()) {
+                t->sendCancel();
+            }
         }
     }
 }
 
+GestureManager::STouchDestroyListener::STouchDestroyListener(
+    GestureManager* manager, wl_client* client, wl_resource* touch
+) :
+    manager(manager), client(client) {
+    this->listener.notify = [](wl_listener* listener, void*) {
+        STouchDestroyListener* self = wl_container_of(listener, self, listener);
+        // also destroys self, and with it the listeners of the client's other touches
+        self->manager->clientTouches.drop(self->client);
+    };
+    wl_resource_add_destroy_listener(touch, &this->listener);
+}
+
+GestureManager::STouchDestroyListener::~STouchDestroyListener() {
+    wl_list_remove(&this->listener.link);
+}
+
+const GestureManager::SClientTouches* GestureManager::touchesOfClient(wl_client* client) {
+    const auto outdated = [](const SClientTouches& entry) {
+        // destroyed touches drop the entry, so more of them means the client bound another one
+        const auto seat = entry.seat.lock();
+        return !seat || seat->m_touches.size() > entry.bound;
+    };
+
+    return this->clientTouches.get(client, outdated, [this](wl_client* client, SClientTouches& entry) {
+        SP<CWLSeatResource> seat = g_pSeatManager->seatResourceForClient(client);
+        if (!seat) {
+            return false;
+        }
+
+        entry.seat  = seat;
+        entry.bound = seat->m_touches.size();
+        for (const auto& touch : seat->m_touches) {
+            if (!touch || !touch->m_resource) {
+                continue;
+            }
+
+            entry.touches.emplace_back(touch);
+            entry.listeners.emplace_back(
+                std::make_unique<STouchDestroyListener>(this, client, touch->m_resource->resource())
+            );
+        }
+
+        // nothing would ever drop an entry without touches
+        return !entry.touches.empty();
+    });
+}
+
 // @return whether or not to inhibit further actions
 bool GestureManager::onTouchDown(ITouch::SDownEvent ev) {
+    if (this->replayingHeld) {
+        return false;
+    }
+
+    this->activateDevice(ev.device);
+    this->touchDevices.down(ev.device, ev.touchID, ev.timeMs);
+    this->listenToDevice(ev.device);
+
+    if (this->passthrough.active) {
+        this->replayPassthrough();
+    } else if (this->m_sGestureState.empty()) {
+        this->refreshGestureDemand();
+        this->held = {};
+
+        // nothing can happen until a second finger lands, skip all the gesture machinery till then
+        if (!this->getGestureDemand().wantsAny(1)) {
+            this->passthrough = {.active = true, .down = ev, .lastMotion = std::nullopt};
+            return false;
+        }
+    }
+
+    if (this->processTouchDown(ev)) {
+        return true;
+    }
+
+    return this->shouldHoldTouchDown(ev) && this->holdTouchEvent(ev);
+}
+
+void GestureManager::replayPassthrough() {
+    this->passthrough.active = false;
+
+    this->processTouchDown(this->passthrough.down);
+    if (this->passthrough.lastMotion) {
+        this->processTouchMove(*this->passthrough.lastMotion);
+    }
+}
+
+void GestureManager::rememberTouchedClient() {
     static auto const SEND_CANCEL = g_config->sendCancel;
 
+    // remember which surfaces were touched, to later send cancel events
+    const auto surface = g_pInputManager->m_touchData.touchFocusSurface;
+    if (!SEND_CANCEL->value() || !surface) {
+        return;
+    }
+
+    wl_client* client = surface.get()->client();
+    if (client && this->touchesOfClient(client)) {
+        this->touchedClients.insert(client);
+    }
+}
+
+bool GestureManager::processTouchDown(ITouch::SDownEvent ev) {
     auto monitor = g_pCompositor->getMonitorFromName(!ev.device->m_boundOutput.empty() ? ev.device->m_boundOutput : "");
     monitor      = monitor ? monitor : Desktop::focusState()->monitor();
 
@@ -613,26 +1094,19 @@ bool GestureManager::onTouchDown(ITouch::SDownEvent ev) {
 
     g_pInputManager->refocus();
 
-    if (this->m_sGestureState.fingers.size() == 0) {
-        this->touchedResources.clear();
-        this->activeTrackpadGesture = nullptr;
-    }
+    if (this->m_sGestureState.empty()) {
+        static auto const RESIZE_LONG_PRESS = g_config->resizeOnBorder;
 
-    if (!eventForwardingInhibited() && SEND_CANCEL->value() && g_pInputManager->m_touchData.touchFocusSurface) {
-        // remember which surfaces were touched, to later send cancel events
-        const auto surface = g_pInputManager->m_touchData.touchFocusSurface;
+        // the border resize is the only decision that needs it so far
+        const auto touchPos = this->wlrTouchEventPositionAsPixels(ev.pos.x, ev.pos.y);
+        this->hitTest       = RESIZE_LONG_PRESS->value() ? this->hitTestWindow(touchPos) : SHitTest{};
 
-        wl_client* client = surface.get()->client();
-        if (client) {
-            SP<CWLSeatResource> seat = g_pSeatManager->seatResourceForClient(client);
+        this->touchedClients.clear();
+        this->dragContext.handler = nullptr;
+    }
 
-            if (seat) {
-                auto touches = seat.get()->m_touches;
-                for (const auto& touch : touches) {
-                    this->touchedResources.insert(touch);
-                }
-            }
-        }
+    if (!eventForwardingInhibited()) {
+        this->rememberTouchedClient();
     }
 
     // NOTE @wlr_touch_down_event.x and y uses a number between 0 and 1 to
@@ -647,19 +1121,39 @@ bool GestureManager::onTouchDown(ITouch::SDownEvent ev) {
         .pos    = pos,
     };
 
-    return IGestureManager::onTouchDown(gesture_event);
+    const auto BLOCK = IGestureManager::onTouchDown(gesture_event);
+    this->warmUpWorkspaceSwipe(pos);
+
+    return BLOCK;
 }
 
 bool GestureManager::onTouchUp(ITouch::SUpEvent ev) {
     static auto const SEND_CANCEL = g_config->sendCancel;
 
-    wf::touch::point_t lift_off_pos;
-    try {
-        lift_off_pos = this->m_sGestureState.fingers.at(ev.touchID).current;
-    } catch (const std::out_of_range&) {
+    if (this->replayingHeld) {
+        return false;
+    }
+
+    const auto device = this->deviceOfTouch(ev.touchID, ev.timeMs);
+    this->activateDevice(device);
+    this->touchDevices.up(device, ev.touchID);
+
+    if (this->passthrough.active) {
+        if (ev.touchID == this->passthrough.down.touchID) {
+            this->passthrough.active = false;
+        }
         return false;
     }
 
+    // the lift off position is wherever the batched motion left the finger
+    this->flushMotion();
+
+    const auto finger = this->m_sGestureState.find(ev.touchID);
+    if (!finger) {
+        return false;
+    }
+    const wf::touch::point_t lift_off_pos = this->m_sGestureState.finger(*finger).current;
+
     const wf::touch::gesture_event_t gesture_event = {
         .type   = wf::touch::EVENT_TYPE_TOUCH_UP,
         .time   = ev.timeMs,
@@ -668,6 +1162,21 @@ bool GestureManager::onTouchUp(ITouch::SUpEvent ev) {
     };
 
     const auto BLOCK = IGestureManager::onTouchUp(gesture_event);
+    if (this->m_sGestureState.empty()) {
+        this->discardWorkspaceSwipeWarmup();
+    } else {
+        this->settleWorkspaceSwipeWarmup();
+    }
+
+    if (!BLOCK && this->held.active) {
+        this->holdTouchEvent(ev);
+        // the touch sequence ended without a gesture claiming it
+        if (this->m_sGestureState.empty()) {
+            this->releaseHeldTouches();
+        }
+        return true;
+    }
+
     if (SEND_CANCEL->value()) {
         const auto surface = g_pInputManager->m_touchData.touchFocusSurface;
 
@@ -680,15 +1189,7 @@ bool GestureManager::onTouchUp(ITouch::SUpEvent ev) {
             return true;
         }
 
-        SP<CWLSeatResource> seat = g_pSeatManager->seatResourceForClient(client);
-        if (!seat.get()) {
-            return true;
-        }
-
-        auto touches = seat.get()->m_touches;
-        for (const auto& touch : touches) {
-            this->touchedResources.remove(touch);
-        }
+        this->touchedClients.remove(client);
 
         return BLOCK;
     } else {
@@ -698,6 +1199,143 @@ bool GestureManager::onTouchUp(ITouch::SUpEvent ev) {
 }
 
 bool GestureManager::onTouchMove(ITouch::SMotionEvent ev) {
+    if (this->replayingHeld) {
+        return false;
+    }
+
+    this->activateDevice(this->deviceOfTouch(ev.touchID, ev.timeMs));
+
+    if (this->passthrough.active) {
+        if (ev.touchID == this->passthrough.down.touchID) {
+            this->passthrough.lastMotion = ev;
+        }
+        return false;
+    }
+
+    if (this->processTouchMove(ev)) {
+        return true;
+    }
+
+    return this->held.active && this->holdTouchEvent(ev);
+}
+
+bool GestureManager::shouldHoldTouchDown(const ITouch::SDownEvent& ev) {
+    static auto const HOLD_WINDOW = g_config->holdWindow;
+    static auto const EDGE_MARGIN = g_config->edgeMargin;
+
+    if (HOLD_WINDOW->value() <= 0 || this->held.done) {
+        return false;
+    }
+    if (this->held.active || this->m_sGestureState.size() > 1) {
+        return true;
+    }
+
+    // single finger touches only need to wait if they could start an edge swipe
+    const auto pos = this->wlrTouchEventPositionAsPixels(ev.pos.x, ev.pos.y);
+    return this->find_swipe_edges(pos, EDGE_MARGIN->value()) != 0;
+}
+
+bool GestureManager::holdTouchEvent(const HeldTouchEvent& ev) {
+    static auto const HOLD_WINDOW = g_config->holdWindow;
+
+    if (!this->held.active) {
+        this->held.active   = true;
+        this->held.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(HOLD_WINDOW->value());
+        this->updateHoldTimer();
+    }
+
+    this->held.events.push_back(ev);
+    if (this->held.events.size() >= MAX_HELD_EVENTS) {
+        this->releaseHeldTouches();
+    }
+
+    return true;
+}
+
+void GestureManager::releaseHeldTouches() {
+    auto events       = std::move(this->held.events);
+    this->held.events = {};
+    this->held.active = false;
+    this->held.done   = true;
+
+    // the input manager runs our hooks for these again, they must reach the windows untouched
+    this->replayingHeld = true;
+    for (const auto& event : events) {
+        std::visit(
+            [this](const auto& e) {
+                using T = std::decay_t<decltype(e)>;
+                if constexpr (std::is_same_v<T, ITouch::SDownEvent>) {
+                    g_pInputManager->onTouchDown(e);
+                    // our hook skipped the touch, the window it went to has to get the cancel too
+                    this->rememberTouchedClient();
+                } else if constexpr (std::is_same_v<T, ITouch::SUpEvent>) {
+                    g_pInputManager->onTouchUp(e);
+                } else {
+                    g_pInputManager->onTouchMove(e);
+                }
+            },
+            event
+        );
+    }
+    this->replayingHeld = false;
+
+    this->updateHoldTimer();
+}
+
+void GestureManager::dropHeldTouches() {
+    this->held.events.clear();
+    this->held.active = false;
+    this->held.done   = true;
+}
+
+void GestureManager::updateHoldTimer() {
+    std::optional<std::chrono::steady_clock::time_point> next;
+    const auto consider = [&next](const SHeldTouches& held) {
+        if (held.active && (!next || held.deadline < *next)) {
+            next = held.deadline;
+        }
+    };
+
+    consider(this->held);
+    for (const auto& session : this->inactiveSessions) {
+        consider(session.held);
+    }
+
+    if (!next) {
+        wl_event_source_timer_update(this->holdTimer, 0);
+        return;
+    }
+
+    const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(*next - std::chrono::steady_clock::now());
+    // 0 would disarm the timer
+    wl_event_source_timer_update(this->holdTimer, std::max<int>(remaining.count(), 1));
+}
+
+void GestureManager::onHoldTimeout() {
+    const auto now = std::chrono::steady_clock::now();
+
+    if (this->held.active && this->held.deadline <= now) {
+        this->releaseHeldTouches();
+    }
+
+    while (true) {
+        const auto it = std::ranges::find_if(this->inactiveSessions, [&now](const auto& s) {
+            return s.held.active && s.held.deadline <= now;
+        });
+        if (it == this->inactiveSessions.end()) {
+            break;
+        }
+
+        this->activateDevice(WP<ITouch>{it->device});
+        this->releaseHeldTouches();
+    }
+
+    this->updateHoldTimer();
+}
+
+bool GestureManager::processTouchMove(ITouch::SMotionEvent ev) {
+    static auto const BATCH_MOTION = g_config->batchMotion;
+
     if (!this->m_lastTouchedMonitor) {
         Log::logger->log(Log::ERR, "[hyprgrass] onTouchMove: where the fuck is my monitor");
         return false;
@@ -712,28 +1350,41 @@ bool GestureManager::onTouchMove(ITouch::SMotionEvent ev) {
         .pos    = pos,
     };
 
-    return IGestureManager::onTouchMove(gesture_event);
+    if (!BATCH_MOTION->value()) {
+        const auto BLOCK = IGestureManager::onTouchMove(gesture_event);
+        this->settleWorkspaceSwipeWarmup();
+        return BLOCK;
+    }
+
+    // libinput hands over all fingers of a frame in one go, the event loop goes idle once
+    // they're all dispatched
+    this->queueMotion(gesture_event);
+    if (!this->motion_frame_idle) {
+        this->motion_frame_idle = wl_event_loop_add_idle(g_pCompositor->m_wlEventLoop, handleMotionFrame, this);
+    }
+
+    return this->eventForwardingInhibited();
+}
+
+void GestureManager::onMotionFrame() {
+    // idle sources are removed by the event loop after they fire
+    this->motion_frame_idle = nullptr;
+    this->flushMotion();
+    this->settleWorkspaceSwipeWarmup();
 }
 
 SMonitorArea GestureManager::getMonitorArea() const {
     return this->m_monitorArea;
 }
 
-void GestureManager::onLongPressTimeout(uint32_t time_msec) {
-    if (this->m_sGestureState.fingers.empty()) {
+void GestureManager::onTimeout(STimeoutTimer& timer) {
+    if (timer.device.expired()) {
         return;
     }
 
-    const auto finger = this->m_sGestureState.fingers.begin();
-
-    const wf::touch::gesture_event_t touch_event = {
-        .type   = wf::touch::EVENT_TYPE_MOTION,
-        .time   = time_msec,
-        .finger = finger->first,
-        .pos    = finger->second.current,
-    };
-
-    IGestureManager::onTouchMove(touch_event);
+    this->activateDevice(timer.device);
+    IGestureManager::onTimeout(timer.deadline);
+    this->settleWorkspaceSwipeWarmup();
 }
 
 wf::touch::point_t GestureManager::wlrTouchEventPositionAsPixels(double x, double y) const {
@@ -747,13 +1398,99 @@ Vector2D GestureManager::pixelPositionToPercentagePosition(wf::touch::point_t po
 }
 
 Vector2D GestureManager::pixelToTrackpadDistance(wf::touch::point_t distancePx) const {
-    static auto const PSWIPEDIST = CConfigValue<Config::INTEGER>("gestures:workspace_swipe_distance");
-    const auto SWIPEDISTANCE     = std::clamp(*PSWIPEDIST, (int64_t)1LL, (int64_t)UINT32_MAX);
+    const auto& ctx          = this->dragContext;
+    const auto delta_percent = distancePx / wf::touch::point_t(ctx.monitorArea.w, ctx.monitorArea.h);
 
-    const auto monArea       = this->getMonitorArea();
-    const auto delta_percent = distancePx / wf::touch::point_t(monArea.w, monArea.h);
+    return Vector2D(delta_percent.x * ctx.swipeDistance, delta_percent.y * ctx.swipeDistance);
+}
 
-    return Vector2D(delta_percent.x * SWIPEDISTANCE, delta_percent.y * SWIPEDISTANCE);
+void GestureManager::addInternalBind(GestureKey gesture, SP<SKeybind> bind) {
+    this->internalBinds.push_back({.gesture = gesture, .bind = std::move(bind)});
+    this->bindIndex.invalidate();
+}
+
+void GestureManager::clearInternalBinds() {
+    this->internalBinds.clear();
+    this->bindIndex.invalidate();
+}
+
+void GestureManager::invalidateGestureDemand() {
+    this->demandInputs.dirty = true;
+}
+
+void GestureManager::onConfigReloaded() {
+    this->bindIndex.invalidate();
+
+    // the reload replaced the widened gaps of a border resize in progress, restoring the gaps from before
+    // the reload at its end would undo it. The resize goes on with the reloaded gaps and keeps them
+    const auto reloadedGapsIn = currentGapsIn();
+    if (this->resizeOnBorderInfo.active) {
+        this->resizeOnBorderInfo.old_gaps_in = reloadedGapsIn;
+    }
+    for (auto& session : this->inactiveSessions) {
+        if (session.resizeOnBorderInfo.active) {
+            session.resizeOnBorderInfo.old_gaps_in = reloadedGapsIn;
+        }
+    }
+}
+
+void GestureManager::refreshGestureDemand() {
+    static auto const WORKSPACE_SWIPE_FINGERS = g_config->workspaceSwipeFingers;
+    static auto const WORKSPACE_SWIPE_EDGE    = g_config->workspaceSwipeEdge;
+    static auto const RESIZE_LONG_PRESS       = g_config->resizeOnBorder;
+
+    this->bindIndex.refresh(this->internalBinds);
+
+    size_t trackpadGestures = 0;
+    for (const auto& handler : g_pShimTrackpadGestures->gestures) {
+        trackpadGestures += handler.m_gestures.size();
+    }
+
+    // config values and trackpad gestures can also change at runtime through hyprctl keyword
+    const auto& inputs = this->demandInputs;
+    if (!inputs.dirty && inputs.bindGeneration == this->bindIndex.getGeneration() &&
+        inputs.trackpadGestures == trackpadGestures &&
+        inputs.workspaceSwipeFingers == WORKSPACE_SWIPE_FINGERS->value() &&
+        inputs.workspaceSwipeEdge == WORKSPACE_SWIPE_EDGE->value() &&
+        inputs.resizeOnBorder == RESIZE_LONG_PRESS->value()) {
+        return;
+    }
+
+    // config reloads may swap out the values the recognizers point to
+    if (inputs.dirty) {
+        this->buildRecognizers();
+    }
+
+    this->demandInputs = {
+        .dirty                 = false,
+        .bindGeneration        = this->bindIndex.getGeneration(),
+        .trackpadGestures      = trackpadGestures,
+        .workspaceSwipeFingers = WORKSPACE_SWIPE_FINGERS->value(),
+        .workspaceSwipeEdge    = WORKSPACE_SWIPE_EDGE->value(),
+        .resizeOnBorder        = RESIZE_LONG_PRESS->value(),
+    };
+
+    GestureDemand demand;
+    this->bindIndex.addDemand(demand);
+
+    for (const auto type : {GestureType::SWIPE, GestureType::EDGE_SWIPE, GestureType::LONG_PRESS, GestureType::PINCH}) {
+        for (const auto& g : g_pShimTrackpadGestures->get(type)->m_gestures) {
+            // edge gestures store their origin in fingerCount
+            demand.add(type, type == GestureType::EDGE_SWIPE ? 0 : static_cast<uint32_t>(g->fingerCount));
+        }
+    }
+
+    if (this->demandInputs.workspaceSwipeFingers > 0) {
+        demand.add(GestureType::SWIPE, static_cast<uint32_t>(this->demandInputs.workspaceSwipeFingers));
+    }
+    if (!this->demandInputs.workspaceSwipeEdge.empty()) {
+        demand.add(GestureType::EDGE_SWIPE, 0);
+    }
+    if (this->demandInputs.resizeOnBorder) {
+        demand.add(GestureType::LONG_PRESS, 1);
+    }
+
+    this->setGestureDemand(demand);
 }
 
 void GestureManager::touchBindDispatcher(std::string args) {
@@ -767,12 +1504,18 @@ void GestureManager::touchBindDispatcher(std::string args) {
     const auto dispatcher     = trim(argsSplit[2]);
     const auto dispatcherArgs = trim(argsSplit[3]);
 
-    this->internalBinds.emplace_back(
-        makeShared<SKeybind>(SKeybind{
-            .key     = key,
-            .handler = dispatcher,
-            .arg     = dispatcherArgs,
-        })
+    const auto gesture = parseGestureKey(key);
+    if (!gesture) {
+        Log::logger->log(Log::ERR, "touchBind called with invalid gesture: {}", key);
+        return;
+    }
+
+    this->addInternalBind(
+        *gesture, makeShared<SKeybind>(SKeybind{
+                      .key     = key,
+                      .handler = dispatcher,
+                      .arg     = dispatcherArgs,
+                  })
     );
 }
 
@@ -1,11 +1,20 @@
 #pragma once
 #include "./gestures/Gestures.hpp"
+#include "./gestures/TouchDevices.hpp"
+#include "ClientCache.hpp"
+#include "GestureBindIndex.hpp"
 #include "ShimTrackpadGestures.hpp"
 #include "VecSet.hpp"
 
 #include <hyprland/src/config/shared/complex/ComplexDataTypes.hpp>
 #include <hyprutils/memory/SharedPtr.hpp>
 
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <variant>
+
 #define private public
 #include <hyprland/src/config/ConfigValue.hpp>
 #include <hyprland/src/config/values/types/BoolValue.hpp>
@@ -15,6 +24,7 @@
 #include <hyprland/src/devices/ITouch.hpp>
 #include <hyprland/src/managers/KeybindManager.hpp>
 #include <hyprland/src/managers/input/trackpad/TrackpadGestures.hpp>
+#include <hyprland/src/protocols/core/Seat.hpp>
 #undef private
 
 enum class GestureEventType {
@@ -27,12 +37,14 @@ struct Cfg {
     // hack to get a C str pointer, we're gonna get rid of all this once hyprlang is dead so I don't really care how
     // ugly it is
     std::string workspaceSwipeFingersName, longPressDelayName, edgeMarginName, workspaceSwipeEdgeName, sensitivityName,
-        sendCancelName, resizeOnBorderName;
+        sendCancelName, resizeOnBorderName, batchMotionName, workspaceSwipeWarmupName, holdWindowName,
+        workspaceSwipeFlingVelocityName, visualizeTouchesName, visualizerTrailName;
 
-    SP<Config::Values::CIntValue> workspaceSwipeFingers, longPressDelay, edgeMargin;
+    SP<Config::Values::CIntValue> workspaceSwipeFingers, longPressDelay, edgeMargin, holdWindow,
+        workspaceSwipeFlingVelocity, visualizerTrail;
     SP<Config::Values::CStringValue> workspaceSwipeEdge;
     SP<Config::Values::CFloatValue> sensitivity;
-    SP<Config::Values::CBoolValue> sendCancel, resizeOnBorder;
+    SP<Config::Values::CBoolValue> sendCancel, resizeOnBorder, batchMotion, workspaceSwipeWarmup, visualizeTouches;
 
     using INT   = Config::Values::CIntValue;
     using STR   = Config::Values::CStringValue;
@@ -44,6 +56,12 @@ struct Cfg {
           workspaceSwipeEdgeName{key(pluginName, "workspace_swipe_edge")},
           sensitivityName{key(pluginName, "sensitivity")}, sendCancelName{key(pluginName, "debug:send_cancel")},
           resizeOnBorderName{key(pluginName, "resize_on_border_long_press")},
+          batchMotionName{key(pluginName, "batch_motion")},
+          workspaceSwipeWarmupName{key(pluginName, "workspace_swipe_warmup")},
+          holdWindowName{key(pluginName, "hold_window")},
+          workspaceSwipeFlingVelocityName{key(pluginName, "workspace_swipe_fling_velocity")},
+          visualizeTouchesName{key(pluginName, "debug:visualize_touches")},
+          visualizerTrailName{key(pluginName, "debug:visualizer_trail")},
           // config options
           workspaceSwipeFingers{makeShared<INT>(
               workspaceSwipeFingersName.data(), "Number of fingers to trigger workspace swipe",
@@ -63,7 +81,28 @@ struct Cfg {
           )},
           resizeOnBorder{
               makeShared<BOOL>(resizeOnBorderName.data(), "Resize window by pressing and holding on borders", true)
-          } {}
+          },
+          batchMotion{makeShared<BOOL>(
+              batchMotionName.data(), "Process the motion of all fingers in an input frame at once", false
+          )},
+          workspaceSwipeWarmup{makeShared<BOOL>(
+              workspaceSwipeWarmupName.data(), "Prepare the workspace swipe as soon as it could start", false
+          )},
+          holdWindow{makeShared<INT>(
+              holdWindowName.data(),
+              "Milliseconds to hold back multi finger and edge touches from windows while gestures are detected", 0
+          )},
+          workspaceSwipeFlingVelocity{makeShared<INT>(
+              workspaceSwipeFlingVelocityName.data(),
+              "Release speed in pixels per second that decides a workspace swipe by its direction alone, 0 to disable", 0
+          )},
+          visualizeTouches{makeShared<BOOL>(
+              visualizeTouchesName.data(), "Draw a circle under every finger touching the screen", false
+          )},
+          visualizerTrail{makeShared<INT>(
+              visualizerTrailName.data(),
+              "Number of earlier positions the touch visualizer fades out behind fingers, up to 8", 0
+          )} {}
 
   private:
     static constexpr std::string key(std::string pluginName, std::string key) {
@@ -73,8 +112,8 @@ struct Cfg {
 
 class GestureManager : public IGestureManager {
   public:
-    uint32_t long_press_next_trigger_time;
-    std::vector<SP<SKeybind>> internalBinds;
+    // binds defined with hyprgrass-bind/hyprgrass.bind, use addInternalBind() to modify
+    std::vector<SInternalBind> internalBinds;
 
     GestureManager();
     ~GestureManager();
@@ -90,59 +129,271 @@ class GestureManager : public IGestureManager {
     // client window/surface
     bool onTouchMove(ITouch::SMotionEvent e);
 
-    void onLongPressTimeout(uint32_t time_msec);
+    // device of the touch point @touchID for an up or motion event at @time
+    WP<ITouch> deviceOfTouch(int32_t touchID, uint32_t time) const;
+    // held touch events are being handed to the input manager again, the hooks already saw them
+    bool isReplayingHeld() const {
+        return this->replayingHeld;
+    }
+
+    // one per touch device, wakes up the recognizers of the device at their next deadline
+    struct STimeoutTimer {
+        GestureManager* manager;
+        WP<ITouch> device;
+        wl_event_source* source = nullptr;
+        // event time the timer is armed for
+        uint32_t deadline = 0;
+    };
+    void onTimeout(STimeoutTimer& timer);
+    // runs the gestures on the motion batched during the last input frame
+    void onMotionFrame();
+    // forwards the touch events held back for longer than hold_window
+    void onHoldTimeout();
+    // runs the binds of completed gestures queued since the event loop was last idle
+    void onDispatchIdle();
+    // applies the drag updates that piled up since the last frame of @monitor
+    void onPreRender(PHLMONITOR monitor);
+
+    void addInternalBind(GestureKey gesture, SP<SKeybind> bind);
+    void clearInternalBinds();
+    // recompute which gestures are consumed at the start of the next touch sequence
+    void invalidateGestureDemand();
+    // the keybinds and the gaps of hyprland may have changed
+    void onConfigReloaded();
 
     // workaround
     void touchBindDispatcher(std::string args);
 
   protected:
     SMonitorArea getMonitorArea() const override;
-    bool findCompletedGesture(const CompletedGestureEvent& gev) const override;
-    bool handleCompletedGesture(const CompletedGestureEvent& gev) override;
+    std::optional<BindHandle> findCompletedGesture(const CompletedGestureEvent& gev) const override;
+    bool handleCompletedGesture(const CompletedGestureEvent& gev, std::optional<BindHandle> binds) override;
     void handleCancelledGesture() override;
 
     void debugLog(const std::string& msg) override;
 
   private:
-    VecSet<CWeakPointer<CWLTouchResource>> touchedResources;
+    // clients touched in this touch sequence, they get the cancel events
+    VecSet<wl_client*> touchedClients;
+    // drops the cached touches of @client once one of its wl_touch resources is destroyed
+    struct STouchDestroyListener {
+        wl_listener listener;
+        GestureManager* manager;
+        wl_client* client;
+
+        STouchDestroyListener(GestureManager* manager, wl_client* client, wl_resource* touch);
+        ~STouchDestroyListener();
+    };
+    // touch resources of the clients that were touched, saves a seat lookup per touch event.
+    // Only clients with a wl_touch have one. It is rebuilt once the client bound another wl_touch and
+    // dropped once any of them is destroyed
+    struct SClientTouches {
+        WP<CWLSeatResource> seat;
+        // touches of the seat when the entry was built
+        size_t bound = 0;
+        std::vector<WP<CWLTouchResource>> touches;
+        std::vector<std::unique_ptr<STouchDestroyListener>> listeners;
+    };
+    ClientCache<wl_client*, SClientTouches> clientTouches;
+    // lazily rebuilt, hence mutable
+    mutable CGestureBindIndex bindIndex;
+    // single finger touch that is forwarded untouched because no one-finger gesture is consumed.
+    // It's replayed into the gesture engine once another finger lands.
+    struct SPassthrough {
+        bool active = false;
+        ITouch::SDownEvent down;
+        std::optional<ITouch::SMotionEvent> lastMotion;
+    } passthrough;
+    // inputs of the last refreshGestureDemand(), it recomputes the demand when any of them changes
+    struct {
+        bool dirty              = true;
+        uint32_t bindGeneration = 0;
+        size_t trackpadGestures = 0;
+        int64_t workspaceSwipeFingers;
+        std::string workspaceSwipeEdge;
+        bool resizeOnBorder;
+    } demandInputs;
     PHLMONITOR m_lastTouchedMonitor;
     SMonitorArea m_monitorArea;
-    wl_event_source* long_press_timer;
-    struct {
+    UP<STimeoutTimer> timeoutTimer;
+    // pending flush of the batched motion, see batch_motion
+    wl_event_source* motion_frame_idle = nullptr;
+    struct SResizeOnBorderInfo {
         bool active = false;
         Config::CCssGapData old_gaps_in;
     } resizeOnBorderInfo;
-    bool workspaceSwipeActive                = false;
-    CTrackpadGestures* activeTrackpadGesture = nullptr;
-    bool mouseBindActive                     = false;
+    // what the first finger of the touch sequence landed on, taken at touch down so that decisions
+    // later in the sequence don't depend on what the input manager found since
+    struct SHitTest {
+        PHLWINDOWREF window;
+        CBox real;
+        // real extended by the border and general:extend_border_grab_area
+        CBox grab;
+        bool floating   = false;
+        bool fullscreen = false;
+        // on a popup of the window
+        bool popup = false;
+        // on the border or grab area of the window, or for tiled windows the gap around it
+        bool onBorder = false;
+    } hitTest;
+    // drag update waiting for the next frame of the monitor the drag happens on
+    struct SDragOutput {
+        bool pending  = false;
+        uint32_t time = 0;
+        PHLMONITORREF monitor;
+    } dragOutput;
+    using HeldTouchEvent = std::variant<ITouch::SDownEvent, ITouch::SUpEvent, ITouch::SMotionEvent>;
+    // touch events held back from windows until the gestures decided on them, see hold_window
+    struct SHeldTouches {
+        bool active = false;
+        // the hold already ended in this touch sequence, the rest of it is forwarded directly
+        bool done = false;
+        std::chrono::steady_clock::time_point deadline;
+        std::vector<HeldTouchEvent> events;
+    } held;
+    static constexpr size_t MAX_HELD_EVENTS = 128;
+    wl_event_source* holdTimer = nullptr;
+    // held events are being handed to the input manager, which calls our hooks again
+    bool replayingHeld = false;
+    // binds of completed gestures, run once the event loop is idle so that slow dispatchers like exec
+    // or lua functions don't hold up the touch events behind them
+    struct SQueuedDispatch {
+        SP<SKeybind> bind;
+        std::chrono::steady_clock::time_point queuedAt;
+    };
+    std::deque<SQueuedDispatch> dispatchQueue;
+    wl_event_source* dispatchIdle = nullptr;
+    // a dispatcher taking longer than this is logged as slow
+    static constexpr auto SLOW_DISPATCH = std::chrono::milliseconds(5);
+    // taken once when a drag begins so that drag updates don't have to query the config
+    struct SDragContext {
+        SMonitorArea monitorArea;
+        // gestures:workspace_swipe_distance, in trackpad units per monitor width/height
+        double swipeDistance = 1;
+        bool verticalAnims   = false;
+        // trackpad gesture handler the drag is forwarded to, null if the drag isn't emulating one
+        CTrackpadGestures* handler = nullptr;
+        uint32_t fingers           = 0;
+    } dragContext;
+    bool workspaceSwipeActive = false;
+    // workspace swipe begun ahead of the drag, see workspace_swipe_warmup
+    bool workspaceSwipeWarm = false;
+    bool mouseBindActive    = false;
     // used by trackpadGesture* functions
     wf::touch::point_t emulatedSwipePoint;
 
-    bool handleGestureBind(std::string bind, GestureEventType);
+    // Touch devices are handled independently. The members above belong to the device that sent
+    // the last event, the state of every other device is parked in an SDeviceSession until it
+    // sends an event again, see activateDevice().
+    struct SDeviceSession {
+        WP<ITouch> device;
+        IGestureManager::Session gestures;
+        // recognizerGeneration the recognizers in @gestures were copied at
+        uint32_t recognizerGeneration = 0;
+        PHLMONITOR lastTouchedMonitor;
+        SMonitorArea monitorArea;
+        UP<STimeoutTimer> timeoutTimer;
+        SPassthrough passthrough;
+        VecSet<wl_client*> touchedClients;
+        SResizeOnBorderInfo resizeOnBorderInfo;
+        SHitTest hitTest;
+        SDragContext dragContext;
+        bool workspaceSwipeActive = false;
+        bool workspaceSwipeWarm   = false;
+        bool mouseBindActive      = false;
+        wf::touch::point_t emulatedSwipePoint;
+        SDragOutput dragOutput;
+        SHeldTouches held;
+    };
+    WP<ITouch> activeDevice;
+    std::vector<SDeviceSession> inactiveSessions;
+    // bumped by buildRecognizers(), parked sessions with older recognizers get the current ones when
+    // they are activated
+    uint32_t recognizerGeneration = 0;
+    // device of each touch point, touch up and motion events don't carry it
+    TouchDevices<WP<ITouch>> touchDevices;
+    // leave the hints for touchDevices, added once a device is first touched
+    struct SDeviceListeners {
+        WP<ITouch> device;
+        CHyprSignalListener down;
+        CHyprSignalListener up;
+        CHyprSignalListener motion;
+    };
+    std::vector<SDeviceListeners> deviceListeners;
+    void listenToDevice(const SP<ITouch>& device);
+
+    // makes @device the one the members above belong to
+    void activateDevice(const WP<ITouch>& device);
+    void swapDeviceSession(SDeviceSession& session);
+    UP<STimeoutTimer> makeTimeoutTimer(const WP<ITouch>& device);
+
+    // adds the client of the touch focus to touchedClients
+    void rememberTouchedClient();
+    bool processTouchDown(ITouch::SDownEvent e);
+    bool processTouchMove(ITouch::SMotionEvent e);
+    // feeds the passthrough touch into the gesture engine
+    void replayPassthrough();
+
+    bool shouldHoldTouchDown(const ITouch::SDownEvent& ev);
+    // holds the event back from windows, always blocks it
+    bool holdTouchEvent(const HeldTouchEvent& ev);
+    // forwards the held events to windows, nothing claimed them
+    void releaseHeldTouches();
+    // forgets the held events, a gesture claimed them
+    void dropHeldTouches();
+    void updateHoldTimer();
+
+    bool handleGestureBind(BindHandle binds, GestureEventType);
+    void queueDispatch(const SP<SKeybind>& bind);
+    // runs the queued binds right away, so that binds that can't wait run after them
+    void flushDispatchQueue();
+    // looks up and runs the mouse binds for the start/end of a drag gesture
+    bool handleDragGestureBind(const DragGestureEvent& gev, GestureEventType);
 
     // converts wlr touch event positions (number between 0.0 to 1.0) to pixel position,
     // takes into consideration monitor size and offset
     wf::touch::point_t wlrTouchEventPositionAsPixels(double x, double y) const;
     // reverse of wlrTouchEventPositionAsPixels
     Vector2D pixelPositionToPercentagePosition(wf::touch::point_t) const;
+    // uses the scale of the drag context
     Vector2D pixelToTrackpadDistance(wf::touch::point_t) const;
+    // finds the window under @touchPos, in pixels, for hitTest
+    SHitTest hitTestWindow(wf::touch::point_t touchPos) const;
+    // snapshots the config and monitor state the drag updates depend on into dragContext
+    void beginDragContext();
     bool handleWorkspaceSwipe(const GestureDirection direction);
     void updateWorkspaceSwipe();
+    // moves a workspace swipe released at fling speed to the side of the cancel ratio it was flung to
+    void flingWorkspaceSwipe();
+    // begins the workspace swipe early if the touch sequence could turn into one
+    void warmUpWorkspaceSwipe(wf::touch::point_t touchPos);
+    // ends a workspace swipe that was warmed up but didn't turn into a drag
+    void discardWorkspaceSwipeWarmup();
+    // discards the warm-up once no recognizer that could become the workspace swipe is left
+    void settleWorkspaceSwipeWarmup();
 
     bool trackpadGestureBegin(const DragGestureEvent& gev);
     void trackpadGestureUpdate(uint32_t time);
     void trackpadGestureEnd(uint32_t time);
 
     bool handleDragGesture(const DragGestureEvent& gev) override;
+    bool startDragGesture(const DragGestureEvent& gev);
     void dragGestureUpdate(const wf::touch::gesture_event_t&) override;
+    void flushDragOutput();
     void handleDragGestureEnd(const DragGestureEvent& gev) override;
 
-    void updateLongPressTimer(uint32_t current_time, uint32_t delay) override;
-    void stopLongPressTimer() override;
+    void updateTimeoutTimer(uint32_t current_time, std::optional<uint32_t> deadline) override;
 
     void sendCancelEventsToWindows() override;
+    // cached touch resources of @client, null if it has no wl_touch
+    const SClientTouches* touchesOfClient(wl_client* client);
+
+    // (re)creates the recognizers, only safe while no fingers are down
+    void buildRecognizers();
+    // collects which gestures are consumed by binds, trackpad gestures and workspace swipe/resize settings
+    void refreshGestureDemand();
 
-    bool findGestureBind(std::string bind, GestureEventType type) const;
+    std::optional<BindHandle> findGestureBind(const SGestureBindKey& key) const;
 };
 
 inline std::unique_ptr<GestureManager> g_pGestureManager;
@@ -194,3 +194,42 @@ void ShimTrackpadGestures::listGestures() {
         }
     }
 }
+
+void ShimTrackpadGestures::invalidate() {
+    this->dirty = true;
+}
+
+uint64_t ShimTrackpadGestures::lookupKey(size_t fingersOrOrigin, uint32_t modMask) {
+    return (static_cast<uint64_t>(modMask) << MOD_MASK_SHIFT) | (fingersOrOrigin & FINGERS_MASK);
+}
+
+void ShimTrackpadGestures::rebuild() {
+    for (size_t i = 0; i < std::size(this->gestures); i++) {
+        this->lookup[i].clear();
+        for (const auto& g : this->gestures[i].m_gestures) {
+            // gestures without a direction (long press) still get an entry
+            this->lookup[i][lookupKey(g->fingerCount, g->modMask)] |= toHyprgrassDirection(g->direction);
+        }
+    }
+
+    this->dirty = false;
+}
+
+std::optional<GestureDirection>
+ShimTrackpadGestures::findDirections(GestureType type, size_t fingersOrOrigin, uint32_t modMask) {
+    if (size_t(type) >= std::size(this->gestures)) {
+        return std::nullopt;
+    }
+
+    if (this->dirty) {
+        this->rebuild();
+    }
+
+    const auto& table = this->lookup[size_t(type)];
+    const auto it     = table.find(lookupKey(fingersOrOrigin, modMask));
+    if (it == table.end()) {
+        return std::nullopt;
+    }
+
+    return it->second;
+}
@@ -1,11 +1,14 @@
 #include "gestures/CompletedGesture.hpp"
 #include "gestures/DragGesture.hpp"
+#include "gestures/GestureKey.hpp"
 #include "gestures/Shared.hpp"
 #include "src/managers/input/trackpad/GestureTypes.hpp"
 #include <any>
 #include <cstddef>
 #include <cstdint>
+#include <optional>
 #include <string>
+#include <unordered_map>
 
 #include <hyprland/src/config/ConfigManager.hpp>
 #include <hyprutils/string/ConstVarList.hpp>
@@ -36,14 +39,14 @@ struct GestureConfig {
     }
 
     static eTrackpadGestureDirection originFromFingers(size_t);
+    inline GestureKey key() const {
+        return GestureKey::make(
+            this->type, toHyprgrassDirection(this->direction), static_cast<uint32_t>(this->fingers()),
+            this->edgeOrigin()
+        );
+    }
     std::string to_string() const {
-        CompletedGestureEvent gev{
-            .type         = this->type,
-            .direction    = toHyprgrassDirection(this->direction),
-            .finger_count = static_cast<uint32_t>(this->type == GestureType::EDGE_SWIPE ? 0 : this->fingers()),
-            .edge_origin  = this->type == GestureType::EDGE_SWIPE ? this->edgeOrigin() : 0,
-        };
-        return gev.to_string();
+        return this->key().to_string();
     }
 };
 
@@ -83,9 +86,24 @@ struct ShimTrackpadGestures {
 
     void listGestures();
 
+    // directions of the gestures of @type bound to @fingersOrOrigin and @modMask, nullopt if there are none.
+    // Lets callers find out if a handler would pick up a gesture without feeding it events.
+    std::optional<GestureDirection> findDirections(GestureType type, size_t fingersOrOrigin, uint32_t modMask);
+    // marks the lookup table as outdated, it will be rebuilt on the next lookup. Must be called after
+    // every change to the gestures of the handlers, the table doesn't notice them on its own
+    void invalidate();
+
     static bool isPinch(eTrackpadGestureDirection dir);
     static bool isSingleDirection(eTrackpadGestureDirection dir);
     static bool isSinglePinchDirection(eTrackpadGestureDirection dir);
+
+  private:
+    bool dirty = true;
+    // per handler, (modMask << MOD_MASK_SHIFT | fingers) -> directions bound
+    std::unordered_map<uint64_t, GestureDirection> lookup[4];
+
+    static uint64_t lookupKey(size_t fingersOrOrigin, uint32_t modMask);
+    void rebuild();
 };
 
 inline std::unique_ptr<ShimTrackpadGestures> g_pShimTrackpadGestures;
@@ -1,90 +1,199 @@
 #include "TouchVisualizer.hpp"
+#include "GestureManager.hpp"
 #include <hyprland/src/Compositor.hpp>
 #include <hyprland/src/desktop/state/FocusState.hpp>
+#include <hyprland/src/helpers/Monitor.hpp>
 #include <hyprland/src/render/Renderer.hpp>
+#include <algorithm>
+#include <cmath>
 
 CBox boxAroundCenter(Vector2D center, double radius) {
     return CBox(center.x - radius, center.y - radius, 2 * radius, 2 * radius);
 }
 
-Visualizer::Visualizer() {
-    const int R = TOUCH_POINT_RADIUS;
+void FingerPos::pushTrail(const Vector2D& pos) {
+    if (this->trail_size == TRAIL_CAPACITY) {
+        this->popTrail();
+    }
+    this->trail[(this->trail_start + this->trail_size) % TRAIL_CAPACITY] = pos;
+    this->trail_size++;
+}
+
+void FingerPos::popTrail() {
+    this->trail_start = (this->trail_start + 1) % TRAIL_CAPACITY;
+    this->trail_size--;
+}
+
+static PHLMONITOR monitorOfDevice(const SP<ITouch>& device) {
+    // same as the gesture manager, see GestureManager::processTouchDown
+    auto monitor = device ? g_pCompositor->getMonitorFromName(device->m_boundOutput) : nullptr;
+    return monitor ? monitor : Desktop::focusState()->monitor();
+}
+
+Visualizer::Visualizer() {}
+
+Visualizer::~Visualizer() {}
+
+SP<Render::ITexture> Visualizer::textureFor(float scale) {
+    const int R = std::max(1, (int)std::round(TOUCH_POINT_RADIUS * scale));
+    if (const auto it = this->textures.find(R); it != this->textures.end()) {
+        return it->second;
+    }
 
-    this->cairoSurface =
-        cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 2 * TOUCH_POINT_RADIUS, 2 * TOUCH_POINT_RADIUS);
-    auto cairo = cairo_create(cairoSurface);
+    auto cairoSurface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 2 * R, 2 * R);
+    auto cairo        = cairo_create(cairoSurface);
 
     cairo_arc(cairo, R, R, R, 0, 2 * PI);
     cairo_set_source_rgba(cairo, 0.8, 0.8, 0.1, 0.6);
     cairo_fill(cairo);
 
     cairo_destroy(cairo);
+    cairo_surface_flush(cairoSurface);
 
-    const unsigned char* data = cairo_image_surface_get_data(this->cairoSurface);
+    const unsigned char* data = cairo_image_surface_get_data(cairoSurface);
 
-    this->texture->allocate(Vector2D{2 * TOUCH_POINT_RADIUS, 2 * TOUCH_POINT_RADIUS});
-    glBindTexture(GL_TEXTURE_2D, this->texture->m_texID);
+    SP<Render::ITexture> texture = makeShared<Render::GL::CGLTexture>();
+    texture->allocate(Vector2D{2.0 * R, 2.0 * R});
+    glBindTexture(GL_TEXTURE_2D, texture->m_texID);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 
-    glTexImage2D(
-        GL_TEXTURE_2D, 0, GL_RGBA, 2 * TOUCH_POINT_RADIUS, 2 * TOUCH_POINT_RADIUS, 0, GL_RGBA, GL_UNSIGNED_BYTE, data
-    );
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 2 * R, 2 * R, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+
+    cairo_surface_destroy(cairoSurface);
+
+    this->textures.emplace(R, texture);
+    return texture;
 }
 
-Visualizer::~Visualizer() {
-    if (this->cairoSurface)
-        cairo_surface_destroy(this->cairoSurface);
+size_t Visualizer::trailLength() const {
+    static auto const TRAIL = g_config->visualizerTrail;
+    return std::clamp<int64_t>(TRAIL->value(), 0, FingerPos::TRAIL_CAPACITY);
 }
 
-void Visualizer::onPreRender() {}
+void Visualizer::onPreRender(PHLMONITOR monitor) {
+    const size_t length = this->trailLength();
+
+    for (auto& finger : this->fingers) {
+        if (finger.trail_size == 0 || finger.monitor.lock() != monitor) {
+            continue;
+        }
+
+        // every trail position fades one step with each frame, so they all need repainting
+        for (size_t age = 0; age < finger.trail_size; age++) {
+            g_pHyprRenderer->damageBox(boxAroundCenter(finger.trailAt(age), TOUCH_POINT_RADIUS));
+        }
+
+        // a finger that stopped has its trail shrink by one each frame until it's gone, a moving one
+        // makes room for the position it leaves behind in this frame
+        const bool moved = finger.last_rendered != finger.curr;
+        if (!moved || finger.trail_size >= length) {
+            finger.popTrail();
+        }
+    }
+}
 
-void Visualizer::onRender() {
-    if (this->finger_positions.size() < 1) {
-        return;
+void Visualizer::onRender(PHLMONITOR monitor) {
+    const size_t length = this->trailLength();
+    const float scale   = monitor->m_scale;
+    SP<Render::ITexture> texture;
+
+    // no damage here, the fingers damaged their old and new boxes when they moved.
+    // All fingers of the output share one texture and are drawn back to back
+    for (auto& finger : this->fingers) {
+        if (finger.monitor.lock() != monitor) {
+            continue;
+        }
+
+        if (!texture) {
+            texture = this->textureFor(scale);
+        }
+
+        const auto draw = [&](const Vector2D& pos, float alpha) {
+            CBox box = boxAroundCenter(pos - monitor->m_position, TOUCH_POINT_RADIUS).scale(scale).round();
+            Render::GL::g_pHyprOpenGL->renderTexture(texture, box, {.a = alpha, .round = 0, .discardActive = true});
+        };
+
+        if (length > 0 && finger.last_rendered && *finger.last_rendered != finger.curr) {
+            finger.pushTrail(*finger.last_rendered);
+        }
+
+        // oldest first, so newer positions are drawn on top
+        for (size_t age = 0; age < finger.trail_size; age++) {
+            draw(finger.trailAt(age), 0.5f * (age + 1) / (finger.trail_size + 1));
+        }
+
+        draw(finger.curr, 1.f);
+        finger.last_rendered = finger.curr;
     }
+}
 
-    const auto monitor = Desktop::focusState()->monitor();
+FingerPos* Visualizer::find(const WP<ITouch>& device, int32_t id) {
+    const auto it = std::ranges::find_if(this->fingers, [&](const auto& finger) {
+        return finger.id == id && finger.device == device;
+    });
+    return it == this->fingers.end() ? nullptr : &*it;
+}
 
-    // HACK: should not damage monitor, however, I don't understand jackshit
-    // about damage so here we are.
-    // If you know how to do damage properly I BEG OF YOU PLEASE ABSOLVE ME
-    // OF MY SINS
-    if (this->finger_positions.size()) {
-        g_pHyprRenderer->damageMonitor(monitor);
+void Visualizer::onTouchDown(ITouch::SDownEvent ev) {
+    const auto mon = monitorOfDevice(ev.device);
+    if (!mon) {
+        return;
     }
 
-    for (auto& finger : this->finger_positions) {
-        CBox dmg = boxAroundCenter(finger.second.curr, TOUCH_POINT_RADIUS);
-        Render::GL::g_pHyprOpenGL->renderTexture(this->texture, dmg, {.a = 1.f, .round = 0, .discardActive = true});
+    auto* finger = this->find(ev.device, ev.touchID);
+    if (!finger) {
+        finger = &this->fingers.emplace_back(FingerPos{.device = ev.device, .id = ev.touchID});
     }
-}
 
-void Visualizer::onTouchDown(ITouch::SDownEvent ev) {
-    auto mon = Desktop::focusState()->monitor();
-    this->finger_positions.emplace(ev.touchID, FingerPos{ev.pos * mon->m_pixelSize + mon->m_position, std::nullopt});
-    g_pCompositor->scheduleFrameForMonitor(mon);
+    finger->monitor       = mon;
+    finger->curr          = mon->m_position + ev.pos * mon->m_size;
+    finger->last_rendered = std::nullopt;
+    finger->trail_size    = 0;
+    this->damageFinger(*finger);
 }
 
-void Visualizer::onTouchUp(ITouch::SUpEvent ev) {
-    this->damageFinger(ev.touchID);
-    this->finger_positions.erase(ev.touchID);
-    g_pCompositor->scheduleFrameForMonitor(Desktop::focusState()->monitor());
-}
+void Visualizer::onTouchUp(ITouch::SUpEvent ev, const WP<ITouch>& device) {
+    auto* finger = this->find(device, ev.touchID);
+    if (!finger) {
+        return;
+    }
+
+    this->damageFinger(*finger);
+    for (size_t age = 0; age < finger->trail_size; age++) {
+        g_pHyprRenderer->damageBox(boxAroundCenter(finger->trailAt(age), TOUCH_POINT_RADIUS));
+    }
 
-void Visualizer::onTouchMotion(ITouch::SMotionEvent ev) {
-    auto mon                           = Desktop::focusState()->monitor();
-    this->finger_positions[ev.touchID] = {ev.pos * mon->m_pixelSize + mon->m_position, std::nullopt};
-    g_pCompositor->scheduleFrameForMonitor(mon);
+    std::erase_if(this->fingers, [&](const auto& f) { return &f == finger; });
 }
 
-void Visualizer::damageFinger(int32_t id) {
-    auto finger = this->finger_positions.at(id);
+void Visualizer::onTouchMotion(ITouch::SMotionEvent ev, const WP<ITouch>& device) {
+    auto* finger = this->find(device, ev.touchID);
+    if (!finger) {
+        return;
+    }
+
+    const auto mon = finger->monitor.lock();
+    if (!mon) {
+        return;
+    }
+
+    const auto pos = mon->m_position + ev.pos * mon->m_size;
+    if (pos == finger->curr) {
+        return;
+    }
+
+    finger->curr = pos;
+    // damaging schedules the frame that draws it
+    this->damageFinger(*finger);
+}
 
+// damages where the finger was last drawn and where it will be drawn next
+void Visualizer::damageFinger(const FingerPos& finger) {
     CBox dm = boxAroundCenter(finger.curr, TOUCH_POINT_RADIUS);
     g_pHyprRenderer->damageBox(dm);
 
-    if (finger.last_rendered.has_value()) {
+    if (finger.last_rendered.has_value() && finger.last_rendered != finger.curr) {
         dm = boxAroundCenter(finger.last_rendered.value(), TOUCH_POINT_RADIUS);
         g_pHyprRenderer->damageBox(dm);
     }
@@ -1,29 +1,63 @@
+#include <hyprland/src/desktop/DesktopTypes.hpp>
 #include <hyprland/src/devices/ITouch.hpp>
 #include <hyprland/src/render/gl/GLTexture.hpp>
 #include <hyprland/src/render/Texture.hpp>
+#include <array>
 #include <cairo/cairo.h>
+#include <optional>
+#include <unordered_map>
+#include <vector>
 
 struct FingerPos {
+    // touch IDs are only unique per device
+    WP<ITouch> device;
+    int32_t id;
+    // the output the touch device maps to, the finger is drawn on that one only
+    PHLMONITORREF monitor;
+    // in layout coordinates
     Vector2D curr;
+    // where the finger was drawn in the last frame, its box has to be damaged once it moves
     std::optional<Vector2D> last_rendered;
+
+    // positions drawn in earlier frames, oldest first, see debug:visualizer_trail
+    static constexpr size_t TRAIL_CAPACITY = 8;
+    std::array<Vector2D, TRAIL_CAPACITY> trail;
+    size_t trail_start = 0;
+    size_t trail_size  = 0;
+
+    const Vector2D& trailAt(size_t age) const {
+        return this->trail[(this->trail_start + age) % TRAIL_CAPACITY];
+    }
+    void pushTrail(const Vector2D& pos);
+    void popTrail();
 };
 
 class Visualizer {
   public:
     Visualizer();
     ~Visualizer();
-    void onPreRender();
-    void onRender();
-    void damageFinger(int32_t id);
+    // fades out the trails of fingers that stopped on @monitor
+    void onPreRender(PHLMONITOR monitor);
+    // draws the fingers of @monitor
+    void onRender(PHLMONITOR monitor);
+    void damageFinger(const FingerPos& finger);
 
     void onTouchDown(ITouch::SDownEvent);
-    void onTouchUp(ITouch::SUpEvent);
-    void onTouchMotion(ITouch::SMotionEvent);
+    // @device is the one of the touch down, the event doesn't say
+    void onTouchUp(ITouch::SUpEvent, const WP<ITouch>& device);
+    void onTouchMotion(ITouch::SMotionEvent, const WP<ITouch>& device);
 
   private:
-    SP<Render::ITexture> texture = makeShared<Render::GL::CGLTexture>();
-    cairo_surface_t* cairoSurface;
-    bool tempDamaged             = false;
+    // in logical pixels
     const int TOUCH_POINT_RADIUS = 30;
-    std::unordered_map<int32_t, FingerPos> finger_positions;
+    // circle textures by their radius in physical pixels, one per output scale in use.
+    // Created on first use since there is no GL context outside of rendering
+    std::unordered_map<int, SP<Render::ITexture>> textures;
+    // few enough fingers that a linear search beats hashing
+    std::vector<FingerPos> fingers;
+
+    SP<Render::ITexture> textureFor(float scale);
+    FingerPos* find(const WP<ITouch>& device, int32_t id);
+    // number of trail positions to draw, up to FingerPos::TRAIL_CAPACITY
+    size_t trailLength() const;
 };
@@ -1,25 +1,98 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <span>
+#include <utility>
 #include <vector>
-#include <hyprland/src/protocols/core/Seat.hpp>
 
-// Probably not compatible with move semantics, I really don't know
-template <class T> class VecSet {
+// Unordered set for a handful of elements, a linear search beats hashing at these sizes.
+// The first N elements are stored inline, it only allocates once there are more.
+template <class T, size_t N = 8> class VecSet {
   public:
-    bool has(const T x);
+    bool has(const T& x) const {
+        for (const auto& i : this->all()) {
+            if (i == x) {
+                return true;
+            }
+        }
+
+        return false;
+    }
 
     // returns whether or not it already exists prior to insert
-    bool insert(const T x);
+    bool insert(const T& x) {
+        if (this->has(x)) {
+            return true;
+        }
+
+        if (this->count < N) {
+            this->inlineSet[this->count++] = x;
+            return false;
+        }
+
+        if (this->count == N) {
+            this->heapSet.assign(this->inlineSet.begin(), this->inlineSet.end());
+            this->inlineSet = {};
+        }
+
+        this->heapSet.push_back(x);
+        this->count++;
+        return false;
+    }
 
     // returns whether or not x was found in the set
-    bool remove(const T x);
+    bool remove(const T& x) {
+        T* data = this->data();
+        for (size_t i = 0; i < this->count; i++) {
+            if (data[i] == x) {
+                data[i] = std::move(data[this->count - 1]);
+                this->pop();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void clear() {
+        this->inlineSet = {};
+        this->heapSet.clear();
+        this->count = 0;
+    }
 
-    void clear();
+    size_t size() const {
+        return this->count;
+    }
 
-    const std::vector<T>& all() const;
+    bool empty() const {
+        return this->count == 0;
+    }
+
+    std::span<const T> all() const {
+        return {this->count > N ? this->heapSet.data() : this->inlineSet.data(), this->count};
+    }
 
   private:
-    std::vector<T> set;
-};
+    std::array<T, N> inlineSet{};
+    // holds all elements instead of inlineSet once there are more than N
+    std::vector<T> heapSet;
+    size_t count = 0;
+
+    T* data() {
+        return this->count > N ? this->heapSet.data() : this->inlineSet.data();
+    }
 
-// For some reason if I put this anywhere else the symbols don't get compiled in.
-// C++ is a beauty
-template class VecSet<Hyprutils::Memory::CWeakPointer<CWLTouchResource>>;
+    void pop() {
+        if (this->count > N) {
+            this->heapSet.pop_back();
+            if (--this->count == N) {
+                std::move(this->heapSet.begin(), this->heapSet.end(), this->inlineSet.begin());
+                this->heapSet.clear();
+            }
+            return;
+        }
+
+        // don't keep a removed element alive, it might hold a reference
+        this->inlineSet[--this->count] = T{};
+    }
+};
@@ -1,13 +1,38 @@
+#pragma once
 #include "Shared.hpp"
-#include <functional>
-#include <memory>
+#include "TouchMetrics.hpp"
+#include <cstdint>
 #include <optional>
 #include <wayfire/touch/touch.hpp>
 
-using UpdateExternalTimerCallback = std::function<void(uint32_t current_timer, uint32_t delay)>;
+// Stages of a recognizer pipeline (see Recognizer.hpp).
+//
+// Every stage has:
+// - void reset(uint32_t time): called when the stage starts receiving events
+// - wf::touch::action_status_t update_state(const TouchMetrics&, const wf::touch::gesture_event_t&)
+// - std::optional<uint32_t> deadline() const: event time at which the stage resolves without
+//   waiting for another event, if there is one
+// - wf::touch::action_status_t on_timeout(): the result once the deadline passed
+class StageBase {
+  public:
+    void reset(uint32_t time) {
+        this->start_time = time;
+    }
+
+    std::optional<uint32_t> deadline() const {
+        return std::nullopt;
+    }
+
+    wf::touch::action_status_t on_timeout() {
+        return wf::touch::ACTION_STATUS_RUNNING;
+    }
+
+  protected:
+    uint32_t start_time = 0;
+};
 
 // swipe and with multiple fingers and directions
-class CMultiAction : public wf::touch::gesture_action_t {
+class CMultiAction : public StageBase {
   private:
     double base_threshold;
     // How much *each* finger is allowed to travel in the wrong direction.
@@ -32,16 +57,23 @@ class CMultiAction : public wf::touch::gesture_action_t {
     // This action should be followed by another that completes upon lifting a
     // finger to achieve a gesture that completes after a multi-finger swipe is
     // done and lifted.
-    wf::touch::action_status_t
-    update_state(const wf::touch::gesture_state_t& state, const wf::touch::gesture_event_t& event) override;
+    wf::touch::action_status_t update_state(const TouchMetrics& metrics, const wf::touch::gesture_event_t& event);
 
-    void reset(uint32_t time) override {
-        gesture_action_t::reset(time);
+    void reset(uint32_t time) {
+        StageBase::reset(time);
         target_direction = 0;
     };
+
+    // too slow, cancelled
+    std::optional<uint32_t> deadline() const {
+        return this->start_time + *this->timeout + 1;
+    }
+    wf::touch::action_status_t on_timeout() {
+        return wf::touch::ACTION_STATUS_CANCELLED;
+    }
 };
 
-class MultiFingerTap : public wf::touch::gesture_action_t {
+class MultiFingerTap : public StageBase {
   private:
     double base_threshold;
     const float* sensitivity;
@@ -51,71 +83,56 @@ class MultiFingerTap : public wf::touch::gesture_action_t {
     MultiFingerTap(double base_threshold, const float* sensitivity, const int64_t* timeout)
         : base_threshold(base_threshold), sensitivity(sensitivity), timeout(timeout) {};
 
-    wf::touch::action_status_t
-    update_state(const wf::touch::gesture_state_t& state, const wf::touch::gesture_event_t& event) override;
+    wf::touch::action_status_t update_state(const TouchMetrics& metrics, const wf::touch::gesture_event_t& event);
+
+    // held too long to be a tap
+    std::optional<uint32_t> deadline() const {
+        return this->start_time + *this->timeout + 1;
+    }
+    wf::touch::action_status_t on_timeout() {
+        return wf::touch::ACTION_STATUS_CANCELLED;
+    }
 };
 
-class LongPress : public wf::touch::gesture_action_t {
+// Restarts on every touch down and completes once the delay has passed since the last one.
+class LongPress : public StageBase {
   private:
     double base_threshold;
     const float* sensitivity;
     const int64_t* delay;
-    UpdateExternalTimerCallback update_external_timer_callback;
 
   public:
-    // TODO: I hope one day I can figure out how not to pass a function for the update timer callback
-    LongPress(
-        double base_threshold, const float* sensitivity, const int64_t* delay,
-        UpdateExternalTimerCallback update_external_timer
-    )
-        : base_threshold(base_threshold), sensitivity(sensitivity), delay(delay),
-          update_external_timer_callback(update_external_timer) {};
-
-    wf::touch::action_status_t
-    update_state(const wf::touch::gesture_state_t& state, const wf::touch::gesture_event_t& event) override;
+    LongPress(double base_threshold, const float* sensitivity, const int64_t* delay)
+        : base_threshold(base_threshold), sensitivity(sensitivity), delay(delay) {};
+
+    int64_t get_delay() const {
+        return *this->delay;
+    }
+
+    wf::touch::action_status_t update_state(const TouchMetrics& metrics, const wf::touch::gesture_event_t& event);
+
+    std::optional<uint32_t> deadline() const {
+        return this->start_time + *this->delay + 1;
+    }
+    wf::touch::action_status_t on_timeout() {
+        return wf::touch::ACTION_STATUS_COMPLETED;
+    }
 };
 
 // Completes upon receiving a touch up event and cancels upon receiving a touch
 // down event.
-class LiftoffAction : public wf::touch::gesture_action_t {
-    wf::touch::action_status_t
-    update_state(const wf::touch::gesture_state_t& state, const wf::touch::gesture_event_t& event) override;
-};
-
-// Completes upon receiving a touch up or touch down event
-class TouchUpOrDownAction : public wf::touch::gesture_action_t {
-    wf::touch::action_status_t
-    update_state(const wf::touch::gesture_state_t& state, const wf::touch::gesture_event_t& event) override;
+class LiftoffAction : public StageBase {
+  public:
+    wf::touch::action_status_t update_state(const TouchMetrics& metrics, const wf::touch::gesture_event_t& event);
 };
 
 // Completes upon all touch points lifted.
-class LiftAll : public wf::touch::gesture_action_t {
-    wf::touch::action_status_t
-    update_state(const wf::touch::gesture_state_t& state, const wf::touch::gesture_event_t& event) override;
-};
-
-// This action is used to call a function right after another action is completed
-class OnCompleteAction : public wf::touch::gesture_action_t {
-    using Callback = std::function<void(uint32_t time, bool cancelled)>;
-
-  private:
-    std::unique_ptr<wf::touch::gesture_action_t> action;
-    const Callback callback;
-
+class LiftAll : public StageBase {
   public:
-    OnCompleteAction(std::unique_ptr<wf::touch::gesture_action_t> action, Callback callback) : callback(callback) {
-        this->action = std::move(action);
-    }
-
-    wf::touch::action_status_t
-    update_state(const wf::touch::gesture_state_t& state, const wf::touch::gesture_event_t& event) override;
-
-    void reset(uint32_t time) override {
-        this->action->reset(time);
-    }
+    wf::touch::action_status_t update_state(const TouchMetrics& metrics, const wf::touch::gesture_event_t& event);
 };
 
-class PinchAction : public wf::touch::gesture_action_t {
+class PinchAction : public StageBase {
   public:
     /**
      * Create a new pinch action.
@@ -133,17 +150,16 @@ class PinchAction : public wf::touch::gesture_action_t {
      * The action is already completed iff no fingers have been added or
      * released and the pinch threshold has been reached without much movement.
      */
-    wf::touch::action_status_t
-    update_state(const wf::touch::gesture_state_t& state, const wf::touch::gesture_event_t& event) override;
+    wf::touch::action_status_t update_state(const TouchMetrics& metrics, const wf::touch::gesture_event_t& event);
 
   protected:
     /**
      * @return True if gesture center has moved more than tolerance.
      */
-    bool exceeds_tolerance(const wf::touch::gesture_state_t& state) override;
+    bool exceeds_tolerance(const TouchMetrics& metrics) const;
 
   private:
-    const float base_threshold;
+    float base_threshold;
     const float* sensitivity;
     std::optional<float> initial_span = std::nullopt;
     uint32_t move_tolerance           = 1e9;
@@ -1,5 +1,7 @@
 #include "CompletedGesture.hpp"
+#include "GestureKey.hpp"
 #include "Shared.hpp"
+#include <charconv>
 #include <string>
 
 std::string stringifyGestureType(const GestureType& type) {
@@ -19,19 +21,69 @@ std::string stringifyGestureType(const GestureType& type) {
 }
 
 std::string CompletedGestureEvent::to_string() const {
-    switch (type) {
-        case GestureType::EDGE_SWIPE:
-            return "edge:" + stringifyDirection(this->edge_origin) + ":" + stringifyDirection(this->direction);
-        case GestureType::SWIPE:
-            return "swipe:" + std::to_string(finger_count) + ":" + stringifyDirection(this->direction);
-            break;
-        case GestureType::TAP:
-            return "tap:" + std::to_string(finger_count);
-        case GestureType::LONG_PRESS:
-            return "longpress:" + std::to_string(finger_count);
-        case GestureType::PINCH:
-            return "pinch:" + std::to_string(finger_count) + ":" + stringifyDirection(this->direction);
+    return GestureKey::from(*this).to_string();
+}
+
+// splits off the segment before the next ':' and advances @s past it
+static std::string_view nextSegment(std::string_view& s) {
+    const auto end     = s.find(':');
+    const auto segment = s.substr(0, end);
+    s                  = end == std::string_view::npos ? std::string_view{} : s.substr(end + 1);
+    return segment;
+}
+
+static std::optional<uint32_t> parseFingerCount(std::string_view s) {
+    uint32_t fingers  = 0;
+    const auto result = std::from_chars(s.data(), s.data() + s.size(), fingers);
+    if (result.ec != std::errc{} || result.ptr != s.data() + s.size() || fingers == 0) {
+        return std::nullopt;
+    }
+
+    return fingers;
+}
+
+std::optional<CompletedGestureEvent> parseCompletedGesture(std::string_view s) {
+    const auto kind = nextSegment(s);
+    CompletedGestureEvent gev{.type = GestureType::SWIPE, .direction = 0, .finger_count = 0, .edge_origin = 0};
+
+    if (kind == "edge") {
+        gev.type = GestureType::EDGE_SWIPE;
+
+        const auto origin = parseDirection(nextSegment(s));
+        if (!origin || *origin == 0) {
+            return std::nullopt;
+        }
+        gev.edge_origin = *origin;
+    } else {
+        if (kind == "swipe") {
+            gev.type = GestureType::SWIPE;
+        } else if (kind == "tap") {
+            gev.type = GestureType::TAP;
+        } else if (kind == "longpress") {
+            gev.type = GestureType::LONG_PRESS;
+        } else if (kind == "pinch") {
+            gev.type = GestureType::PINCH;
+        } else {
+            return std::nullopt;
+        }
+
+        const auto fingers = parseFingerCount(nextSegment(s));
+        if (!fingers) {
+            return std::nullopt;
+        }
+        gev.finger_count = *fingers;
+    }
+
+    // tap and longpress have no direction segment
+    if (gev.type == GestureType::TAP || gev.type == GestureType::LONG_PRESS) {
+        return s.empty() ? std::optional{gev} : std::nullopt;
+    }
+
+    const auto direction = parseDirection(nextSegment(s));
+    if (!direction || *direction == 0 || !s.empty()) {
+        return std::nullopt;
     }
+    gev.direction = *direction;
 
-    return "";
+    return gev;
 }
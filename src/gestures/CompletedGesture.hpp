@@ -1,6 +1,8 @@
 #pragma once
 #include "Shared.hpp"
+#include <optional>
 #include <string>
+#include <string_view>
 
 enum class GestureType {
     // Invalid Gesture
@@ -23,8 +25,12 @@ struct CompletedGestureEvent {
     GestureDirection edge_origin;
 
     std::string to_string() const;
-    inline bool operator==(const CompletedGestureEvent& other) {
+    inline bool operator==(const CompletedGestureEvent& other) const {
         return type == other.type && direction == other.direction && finger_count == other.finger_count &&
                edge_origin == other.edge_origin;
     }
 };
+
+// reverse of CompletedGestureEvent::to_string(), returns std::nullopt if @s is not a gesture
+// e.g. "swipe:3:l", "edge:d:u", "tap:3"
+std::optional<CompletedGestureEvent> parseCompletedGesture(std::string_view s);
@@ -0,0 +1,44 @@
+#include "Deadlines.hpp"
+#include <algorithm>
+
+// whether @a comes before @b, correct across a wrap around of the timestamps
+static bool before(uint32_t a, uint32_t b) {
+    return static_cast<int32_t>(a - b) < 0;
+}
+
+// std::*_heap keep the largest element on top
+static bool later(const DeadlineQueue::Entry& a, const DeadlineQueue::Entry& b) {
+    return before(b.deadline, a.deadline);
+}
+
+void DeadlineQueue::push(uint32_t deadline, size_t recognizer) {
+    this->heap.push_back({.deadline = deadline, .recognizer = recognizer});
+    std::push_heap(this->heap.begin(), this->heap.end(), later);
+}
+
+std::optional<DeadlineQueue::Entry> DeadlineQueue::top() const {
+    if (this->heap.empty()) {
+        return std::nullopt;
+    }
+
+    return this->heap.front();
+}
+
+void DeadlineQueue::pop() {
+    std::pop_heap(this->heap.begin(), this->heap.end(), later);
+    this->heap.pop_back();
+}
+
+std::optional<DeadlineQueue::Entry> DeadlineQueue::popDue(uint32_t time) {
+    const auto entry = this->top();
+    if (!entry || before(time, entry->deadline)) {
+        return std::nullopt;
+    }
+
+    this->pop();
+    return entry;
+}
+
+void DeadlineQueue::clear() {
+    this->heap.clear();
+}
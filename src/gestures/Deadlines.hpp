@@ -0,0 +1,33 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// Min-heap of the times at which recognizers resolve on their own, see Pipeline::deadline().
+//
+// Times are event timestamps in milliseconds and may wrap around. Entries are not removed when a
+// recognizer's deadline changes; whoever pops one has to check that it is still current.
+class DeadlineQueue {
+  public:
+    struct Entry {
+        uint32_t deadline;
+        // index of the recognizer in the gesture manager
+        size_t recognizer;
+    };
+
+    void push(uint32_t deadline, size_t recognizer);
+    // the entry with the earliest deadline, if any
+    std::optional<Entry> top() const;
+    void pop();
+    // removes and returns the earliest entry if it is due at @time
+    std::optional<Entry> popDue(uint32_t time);
+    void clear();
+
+    bool empty() const {
+        return this->heap.empty();
+    }
+
+  private:
+    std::vector<Entry> heap;
+};
@@ -0,0 +1,24 @@
+#include "GestureKey.hpp"
+#include "Shared.hpp"
+#include <string>
+
+std::string GestureKey::to_string() const {
+    switch (this->type()) {
+        case GestureType::EDGE_SWIPE:
+            return "edge:" + stringifyDirection(this->edgeOrigin()) + ":" + stringifyDirection(this->direction());
+        case GestureType::SWIPE:
+            return "swipe:" + std::to_string(this->fingers()) + ":" + stringifyDirection(this->direction());
+        case GestureType::TAP:
+            return "tap:" + std::to_string(this->fingers());
+        case GestureType::LONG_PRESS:
+            return "longpress:" + std::to_string(this->fingers());
+        case GestureType::PINCH:
+            return "pinch:" + std::to_string(this->fingers()) + ":" + stringifyDirection(this->direction());
+    }
+
+    return "";
+}
+
+std::optional<GestureKey> parseGestureKey(std::string_view s) {
+    return parseCompletedGesture(s).transform([](const CompletedGestureEvent& gev) { return GestureKey::from(gev); });
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include "CompletedGesture.hpp"
+#include "DragGesture.hpp"
+#include "Shared.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// Identity of a gesture as far as binds are concerned, packed into 32 bits so it can be compared and hashed as an
+// integer. Equivalent to the "swipe:3:l"/"edge:d:u" strings used in config: tap and long press have no direction,
+// and edge swipes have no finger count.
+//
+// layout (lowest bit first):
+// - 4 bits type
+// - 6 bits direction
+// - 6 bits edge origin
+// - 16 bits finger count
+class GestureKey {
+  public:
+    constexpr GestureKey() = default;
+
+    static constexpr GestureKey make(
+        GestureType type, GestureDirection direction, uint32_t finger_count, GestureDirection edge_origin
+    ) {
+        const bool hasDirection = type != GestureType::TAP && type != GestureType::LONG_PRESS;
+        const bool isEdge       = type == GestureType::EDGE_SWIPE;
+
+        GestureKey key;
+        key.value = static_cast<uint32_t>(type) & TYPE_MASK;
+        key.value |= (hasDirection ? direction & DIRECTION_MASK : 0) << DIRECTION_SHIFT;
+        key.value |= (isEdge ? edge_origin & DIRECTION_MASK : 0) << EDGE_SHIFT;
+        key.value |= (isEdge ? 0 : finger_count & FINGERS_MASK) << FINGERS_SHIFT;
+        return key;
+    }
+
+    static constexpr GestureKey from(const CompletedGestureEvent& gev) {
+        return make(gev.type, gev.direction, gev.finger_count, gev.edge_origin);
+    }
+
+    static constexpr GestureKey from(const DragGestureEvent& gev) {
+        return make(gev.type, gev.direction, gev.finger_count, gev.edge_origin);
+    }
+
+    constexpr GestureType type() const {
+        return static_cast<GestureType>(this->value & TYPE_MASK);
+    }
+
+    constexpr GestureDirection direction() const {
+        return (this->value >> DIRECTION_SHIFT) & DIRECTION_MASK;
+    }
+
+    constexpr GestureDirection edgeOrigin() const {
+        return (this->value >> EDGE_SHIFT) & DIRECTION_MASK;
+    }
+
+    constexpr uint32_t fingers() const {
+        return (this->value >> FINGERS_SHIFT) & FINGERS_MASK;
+    }
+
+    constexpr uint32_t raw() const {
+        return this->value;
+    }
+
+    // only meant for logging and debug output
+    std::string to_string() const;
+
+    constexpr bool operator==(const GestureKey&) const = default;
+
+  private:
+    static constexpr uint32_t TYPE_MASK       = 0xF;
+    static constexpr uint32_t DIRECTION_MASK  = 0x3F;
+    static constexpr uint32_t FINGERS_MASK    = 0xFFFF;
+    static constexpr uint32_t DIRECTION_SHIFT = 4;
+    static constexpr uint32_t EDGE_SHIFT      = 10;
+    static constexpr uint32_t FINGERS_SHIFT   = 16;
+
+    uint32_t value = 0;
+};
+
+// returns std::nullopt if @s is not a valid gesture, see parseCompletedGesture()
+std::optional<GestureKey> parseGestureKey(std::string_view s);
+
+template <>
+struct std::hash<GestureKey> {
+    size_t operator()(const GestureKey& key) const noexcept {
+        return std::hash<uint32_t>{}(key.raw());
+    }
+};
@@ -1,5 +1,6 @@
 #include "Gestures.hpp"
 #include "Actions.hpp"
+#include "Recognizer.hpp"
 #include "CompletedGesture.hpp"
 #include "DragGesture.hpp"
 #include "Shared.hpp"
@@ -7,25 +8,174 @@
 #include <memory>
 #include <optional>
 #include <utility>
+#include <variant>
 #include <wayfire/touch/touch.hpp>
 
 void IGestureManager::updateGestures(const wf::touch::gesture_event_t& ev) {
-    if (m_sGestureState.fingers.size() == 1 && ev.type == wf::touch::EVENT_TYPE_TOUCH_DOWN) {
+    bool should_reset = m_sGestureState.size() == 1 && ev.type == wf::touch::EVENT_TYPE_TOUCH_DOWN;
+    if (should_reset) {
         this->inhibitTouchEvents       = false;
         this->activeDragGesture        = std::nullopt;
         this->promisedCompletedGesture = std::nullopt;
+
+        this->m_vLiveGestures.clear();
+        this->clearDeadlines();
+        for (size_t i = 0; i < m_vRecognizers.size(); i++) {
+            if (this->isGestureDemanded(i)) {
+                std::visit([&ev](auto& recognizer) { recognizer.reset(ev.time); }, m_vRecognizers[i]);
+                this->m_vLiveGestures.push_back(i);
+            }
+        }
+    }
+
+    this->gestureTriggered = false;
+
+    // cancelled/completed gestures ignore further events until reset, so drop them
+    // from the live set instead of visiting them on every event
+    const bool fingersAdded = ev.type == wf::touch::EVENT_TYPE_TOUCH_DOWN;
+    size_t live             = 0;
+    for (const size_t i : this->m_vLiveGestures) {
+        // with more fingers down nothing may be bound to this gesture anymore
+        if (fingersAdded && !this->isGestureDemanded(i)) {
+            this->dropDeadline(i);
+            continue;
+        }
+
+        auto& recognizer = m_vRecognizers[i];
+        if (!this->gestureTriggered) {
+            std::visit(
+                [this, &ev](auto& r) {
+                    r.update(this->m_sPendingMetrics, ev, [this](auto& r, size_t stage, auto status, const auto& ev) {
+                        this->onStage(r, stage, status, ev);
+                    });
+                },
+                recognizer
+            );
+        }
+
+        if (this->getGestureStatus(i) == wf::touch::GESTURE_STATUS_RUNNING) {
+            this->m_vLiveGestures[live++] = i;
+            this->registerDeadline(i);
+        } else {
+            this->dropDeadline(i);
+        }
     }
-    bool should_reset      = m_sGestureState.fingers.size() == 1 && ev.type == wf::touch::EVENT_TYPE_TOUCH_DOWN;
+    this->m_vLiveGestures.resize(live);
+
+    this->updateTimer(ev.time);
+}
+
+bool IGestureManager::onTimeout(uint32_t time) {
+    this->flushMotion();
     this->gestureTriggered = false;
-    for (const auto& gesture : m_vGestures) {
-        if (should_reset) {
-            gesture->reset(ev.time);
+
+    bool resolved = false;
+    while (const auto entry = this->m_sDeadlines.popDue(time)) {
+        // outdated entry, the recognizer moved on since
+        if (!this->isCurrentDeadline(*entry)) {
+            continue;
         }
+        const size_t i                  = entry->recognizer;
+        this->m_vRegisteredDeadlines[i] = std::nullopt;
 
         if (!this->gestureTriggered) {
-            gesture->update_state(ev);
+            std::visit(
+                [this, time](auto& r) {
+                    r.timeout(time, [this](auto& r, size_t stage, auto status, const auto& ev) {
+                        this->onStage(r, stage, status, ev);
+                    });
+                },
+                m_vRecognizers[i]
+            );
+            resolved = true;
         }
+
+        // the next stage may have a deadline of its own
+        this->registerDeadline(i);
     }
+
+    if (resolved && this->activeDragGesture.has_value()) {
+        this->dragGestureUpdate({.type = wf::touch::EVENT_TYPE_MOTION, .time = time});
+    }
+
+    this->updateTimer(time);
+    return this->eventForwardingInhibited();
+}
+
+void IGestureManager::registerDeadline(size_t index) {
+    const auto deadline = std::visit([](const auto& r) { return r.deadline(); }, m_vRecognizers[index]);
+    if (deadline == this->m_vRegisteredDeadlines[index]) {
+        return;
+    }
+
+    this->m_vRegisteredDeadlines[index] = deadline;
+    if (deadline) {
+        this->m_sDeadlines.push(*deadline, index);
+    }
+}
+
+void IGestureManager::dropDeadline(size_t index) {
+    // the heap entry is left behind, it no longer matches and gets skipped
+    this->m_vRegisteredDeadlines[index] = std::nullopt;
+}
+
+bool IGestureManager::isCurrentDeadline(const DeadlineQueue::Entry& entry) const {
+    // recognizers may have been rebuilt since
+    return entry.recognizer < this->m_vRegisteredDeadlines.size() &&
+           this->m_vRegisteredDeadlines[entry.recognizer] == entry.deadline;
+}
+
+void IGestureManager::clearDeadlines() {
+    this->m_sDeadlines.clear();
+    this->m_vRegisteredDeadlines.assign(m_vRecognizers.size(), std::nullopt);
+}
+
+void IGestureManager::updateTimer(uint32_t current_time) {
+    // outdated entries on top would only cause an early wakeup
+    auto top = this->m_sDeadlines.top();
+    while (top && !this->isCurrentDeadline(*top)) {
+        this->m_sDeadlines.pop();
+        top = this->m_sDeadlines.top();
+    }
+
+    const auto next = top ? std::optional(top->deadline) : std::nullopt;
+    if (next != this->m_iArmedDeadline) {
+        this->m_iArmedDeadline = next;
+        this->updateTimeoutTimer(current_time, next);
+    }
+}
+
+bool IGestureManager::isGestureDemanded(size_t index) const {
+    const auto fingers = static_cast<uint32_t>(m_sGestureState.size());
+    const auto type    = std::visit([](const auto& r) { return r.kind.TYPE; }, m_vRecognizers[index]);
+    return m_sGestureDemand.reachable(type, fingers);
+}
+
+bool IGestureManager::hasLiveGesture(GestureType type) const {
+    // recognizers that timed out stay in the live set until the next event
+    return std::ranges::any_of(this->m_vLiveGestures, [&](size_t i) {
+        const auto kind = std::visit([](const auto& r) { return r.kind.TYPE; }, m_vRecognizers[i]);
+        return kind == type && this->getGestureStatus(i) == wf::touch::GESTURE_STATUS_RUNNING;
+    });
+}
+
+double IGestureManager::getGestureProgress(size_t index) const {
+    return std::visit([](const auto& r) { return r.get_progress(); }, m_vRecognizers.at(index));
+}
+
+wf::touch::gesture_status_t IGestureManager::getGestureStatus(size_t index) const {
+    return std::visit([](const auto& r) { return r.get_status(); }, m_vRecognizers.at(index));
+}
+
+void IGestureManager::prepareEvent(const wf::touch::gesture_event_t& ev) {
+    this->m_sPendingState.update(ev);
+    this->m_sPendingMetrics.update(this->m_sPendingState);
+    this->m_sTouchHistory.update(ev, this->m_sPendingState);
+}
+
+void IGestureManager::commitEvent(const wf::touch::gesture_event_t& ev) {
+    this->m_sGestureState.update(ev);
+    this->m_sTouchMetrics = this->m_sPendingMetrics;
 }
 
 void IGestureManager::cancelTouchEventsOnAllWindows() {
@@ -40,12 +190,12 @@ bool IGestureManager::reserveCompletedGesture(const CompletedGestureEvent& gev)
         return false;
     }
 
-    bool handled = this->findCompletedGesture(gev);
-    if (handled) {
-        this->promisedCompletedGesture = gev;
+    auto binds = this->findCompletedGesture(gev);
+    if (binds) {
+        this->promisedCompletedGesture = PromisedGesture{.event = gev, .binds = *binds};
     }
 
-    return handled;
+    return binds.has_value();
 }
 
 bool IGestureManager::emitCompletedGesture(const CompletedGestureEvent& gev) {
@@ -53,14 +203,19 @@ bool IGestureManager::emitCompletedGesture(const CompletedGestureEvent& gev) {
         return false;
     }
 
-    if (this->promisedCompletedGesture && gev != this->promisedCompletedGesture.value()) {
-        return false;
+    std::optional<BindHandle> binds;
+    if (this->promisedCompletedGesture) {
+        if (gev != this->promisedCompletedGesture->event) {
+            return false;
+        }
+        binds = this->promisedCompletedGesture->binds;
     }
 
-    bool handled = this->handleCompletedGesture(gev);
+    bool handled = this->handleCompletedGesture(gev, binds);
     if (handled) {
         this->gestureTriggered = true;
-        this->stopLongPressTimer();
+        // like a stopped timer, deadlines that don't change are not queued again
+        this->m_sDeadlines.clear();
     }
 
     return handled;
@@ -75,7 +230,8 @@ bool IGestureManager::emitDragGesture(const DragGestureEvent& gev) {
     if (handled) {
         this->gestureTriggered  = true;
         this->activeDragGesture = std::optional(gev);
-        this->stopLongPressTimer();
+        // like a stopped timer, deadlines that don't change are not queued again
+        this->m_sDeadlines.clear();
     }
 
     return handled;
@@ -93,11 +249,14 @@ bool IGestureManager::emitDragGestureEnd(const DragGestureEvent& gev) {
 
 // @return whether or not to inhibit further actions
 bool IGestureManager::onTouchDown(const wf::touch::gesture_event_t& ev) {
+    this->flushMotion();
+
     // NOTE @m_sGestureState is used in gesture-completed callbacks
     // during touch down it must be updated before updating the gestures
     // in touch up and motion, it must be updated AFTER updating the
     // gestures
-    this->m_sGestureState.update(ev);
+    this->prepareEvent(ev);
+    this->commitEvent(ev);
     this->updateGestures(ev);
 
     if (this->activeDragGesture.has_value()) {
@@ -108,8 +267,11 @@ bool IGestureManager::onTouchDown(const wf::touch::gesture_event_t& ev) {
 }
 
 bool IGestureManager::onTouchUp(const wf::touch::gesture_event_t& ev) {
+    this->flushMotion();
+
+    this->prepareEvent(ev);
     this->updateGestures(ev);
-    this->m_sGestureState.update(ev);
+    this->commitEvent(ev);
 
     if (this->activeDragGesture.has_value()) {
         this->dragGestureUpdate(ev);
@@ -119,8 +281,39 @@ bool IGestureManager::onTouchUp(const wf::touch::gesture_event_t& ev) {
 }
 
 bool IGestureManager::onTouchMove(const wf::touch::gesture_event_t& ev) {
+    this->flushMotion();
+
+    this->prepareEvent(ev);
     this->updateGestures(ev);
-    this->m_sGestureState.update(ev);
+    this->commitEvent(ev);
+
+    if (this->activeDragGesture.has_value()) {
+        this->dragGestureUpdate(ev);
+    }
+
+    return this->eventForwardingInhibited();
+}
+
+void IGestureManager::queueMotion(const wf::touch::gesture_event_t& ev) {
+    this->m_sPendingState.update(ev);
+    this->m_sTouchHistory.update(ev, this->m_sPendingState);
+    this->m_sQueuedMotion = ev;
+}
+
+bool IGestureManager::flushMotion() {
+    if (!this->m_sQueuedMotion) {
+        return this->eventForwardingInhibited();
+    }
+
+    // the last event stands in for the whole frame, the recognizers only care about its type
+    // and time, the positions come from the metrics
+    const auto ev = *this->m_sQueuedMotion;
+    this->m_sQueuedMotion.reset();
+
+    this->m_sPendingMetrics.update(this->m_sPendingState);
+    this->updateGestures(ev);
+    this->m_sGestureState = this->m_sPendingState;
+    this->m_sTouchMetrics = this->m_sPendingMetrics;
 
     if (this->activeDragGesture.has_value()) {
         this->dragGestureUpdate(ev);
@@ -153,114 +346,171 @@ GestureDirection IGestureManager::find_swipe_edges(wf::touch::point_t point, int
     return edge_directions;
 }
 
-void IGestureManager::addTouchGesture(std::unique_ptr<wf::touch::gesture_t> gesture) {
-    this->m_vGestures.emplace_back(std::move(gesture));
+IGestureManager::Session IGestureManager::newSession() const {
+    return Session{.recognizers = this->m_vRecognizers};
+}
+
+void IGestureManager::adoptRecognizers(Session& session) const {
+    session.recognizers = this->m_vRecognizers;
+    session.liveGestures.clear();
+    session.deadlines.clear();
+    session.registeredDeadlines.assign(session.recognizers.size(), std::nullopt);
+    session.armedDeadline.reset();
+}
+
+void IGestureManager::swapSession(Session& session) {
+    std::swap(this->m_sGestureState, session.gestureState);
+    std::swap(this->m_sPendingState, session.pendingState);
+    std::swap(this->m_sTouchMetrics, session.touchMetrics);
+    std::swap(this->m_sPendingMetrics, session.pendingMetrics);
+    std::swap(this->m_sTouchHistory, session.touchHistory);
+    std::swap(this->m_sQueuedMotion, session.queuedMotion);
+    std::swap(this->m_vRecognizers, session.recognizers);
+    std::swap(this->m_vLiveGestures, session.liveGestures);
+    std::swap(this->activeDragGesture, session.activeDragGesture);
+    std::swap(this->promisedCompletedGesture, session.promisedCompletedGesture);
+    std::swap(this->m_sDeadlines, session.deadlines);
+    std::swap(this->m_vRegisteredDeadlines, session.registeredDeadlines);
+    std::swap(this->m_iArmedDeadline, session.armedDeadline);
+    std::swap(this->inhibitTouchEvents, session.inhibitTouchEvents);
+    std::swap(this->gestureTriggered, session.gestureTriggered);
+}
+
+void IGestureManager::addRecognizer(Recognizer recognizer) {
+    this->m_vRecognizers.push_back(std::move(recognizer));
+}
+
+void IGestureManager::clearRecognizers() {
+    this->m_vRecognizers.clear();
+    this->m_vLiveGestures.clear();
+    this->clearDeadlines();
 }
 
 void IGestureManager::addMultiFingerGesture(
     double base_threshold, double base_finger_slip, const float* sensitivity, const int64_t* timeout
 ) {
-    auto swipe = std::make_unique<CMultiAction>(base_threshold, base_finger_slip, sensitivity, timeout);
+    this->addRecognizer(SwipeRecognizer{
+        SwipeKind{}, CMultiAction(base_threshold, base_finger_slip, sensitivity, timeout), LiftoffAction{}
+    });
+}
 
-    auto swipe_ptr = swipe.get();
+void IGestureManager::addMultiFingerTap(double base_finger_slip, const float* sensitivity, const int64_t* timeout) {
+    this->addRecognizer(TapRecognizer{TapKind{}, MultiFingerTap(base_finger_slip, sensitivity, timeout)});
+}
 
-    auto swipe_and_emit =
-        std::make_unique<OnCompleteAction>(std::move(swipe), [=, this](uint32_t time, bool cancelled) {
-            if (cancelled || this->activeDragGesture.has_value()) {
-                return;
-            }
+void IGestureManager::addLongPress(double base_finger_slip, const float* sensitivity, const int64_t* delay) {
+    this->addRecognizer(LongPressRecognizer{LongPressKind{}, LongPress(base_finger_slip, sensitivity, delay), LiftAll{}}
+    );
+}
+
+void IGestureManager::addEdgeSwipeGesture(
+    double base_threshold, double base_finger_slip, const float* sensitivity, const int64_t* timeout,
+    const long int* edge_margin
+) {
+    // TODO do I really need this:
+    // edge->set_move_tolerance(SWIPE_INCORRECT_DRAG_TOLERANCE * *sensitivity);
+
+    // The release action needs longer duration to handle the case where the
+    // gesture is actually longer than the max distance.
+    // TODO make this adjustable:
+    // edge_release->set_duration(GESTURE_BASE_DURATION * 1.5 * *sensitivity);
+    this->addRecognizer(EdgeSwipeRecognizer{
+        EdgeSwipeKind{.edge_margin = edge_margin},
+        CMultiAction(base_threshold, base_finger_slip, sensitivity, timeout),
+        LiftoffAction{},
+    });
+}
+
+// TODO: timeouts (also in other gestures)
+void IGestureManager::addPinchGesture(double base_threshold, const float* sensitivity, const int64_t* timeout) {
+    this->addRecognizer(PinchRecognizer{PinchKind{}, PinchAction(base_threshold, sensitivity), LiftoffAction{}});
+}
+
+// a stage that completed or got cancelled, ALREADY_COMPLETED stages are skipped like they were never there
+static bool stageEnded(wf::touch::action_status_t status) {
+    return status == wf::touch::ACTION_STATUS_COMPLETED || status == wf::touch::ACTION_STATUS_CANCELLED;
+}
 
+void IGestureManager::onStage(
+    SwipeRecognizer& r, size_t stage, wf::touch::action_status_t status, const wf::touch::gesture_event_t& ev
+) {
+    const auto& swipe = std::get<0>(r.stages);
+
+    if (stage == 0 && stageEnded(status)) {
+        if (status == wf::touch::ACTION_STATUS_COMPLETED && !this->activeDragGesture.has_value()) {
             const auto gesture = DragGestureEvent{
-                .time         = time,
+                .time         = ev.time,
                 .type         = GestureType::SWIPE,
-                .direction    = swipe_ptr->target_direction,
-                .finger_count = static_cast<uint32_t>(this->m_sGestureState.fingers.size())
+                .direction    = swipe.target_direction,
+                .finger_count = static_cast<uint32_t>(this->m_sGestureState.size())
             };
             const auto completed = CompletedGestureEvent{
                 .type         = GestureType::SWIPE,
-                .direction    = swipe_ptr->target_direction,
-                .finger_count = static_cast<uint32_t>(this->m_sGestureState.fingers.size())
+                .direction    = swipe.target_direction,
+                .finger_count = static_cast<uint32_t>(this->m_sGestureState.size())
             };
 
             if (this->emitDragGesture(gesture) || this->reserveCompletedGesture(completed)) {
                 this->cancelTouchEventsOnAllWindows();
             }
-        });
-
-    auto swipe_liftoff = std::make_unique<LiftoffAction>();
-    auto liftoff_and_ack =
-        std::make_unique<OnCompleteAction>(std::move(swipe_liftoff), [=, this](uint32_t time, bool _) {
-            const auto drag = DragGestureEvent{
-                .time         = time,
+        }
+    } else if (stage == 1 && stageEnded(status)) {
+        const auto drag = DragGestureEvent{
+            .time         = ev.time,
+            .type         = GestureType::SWIPE,
+            .direction    = 0,
+            .finger_count = static_cast<uint32_t>(this->m_sGestureState.size())
+        };
+        if (!this->emitDragGestureEnd(drag)) {
+            const auto gesture = CompletedGestureEvent{
                 .type         = GestureType::SWIPE,
-                .direction    = 0,
-                .finger_count = static_cast<uint32_t>(this->m_sGestureState.fingers.size())
+                .direction    = swipe.target_direction,
+                .finger_count = static_cast<uint32_t>(this->m_sGestureState.size()),
             };
-            if (this->emitDragGestureEnd(drag)) {
-                return;
-            } else {
-                const auto gesture = CompletedGestureEvent{
-                    .type         = GestureType::SWIPE,
-                    .direction    = swipe_ptr->target_direction,
-                    .finger_count = static_cast<uint32_t>(this->m_sGestureState.fingers.size()),
-                };
-
-                // cancel event already sent to windows on 3 finger down
-                this->emitCompletedGesture(gesture);
-            }
-        });
-
-    std::vector<std::unique_ptr<wf::touch::gesture_action_t>> swipe_actions;
-    swipe_actions.emplace_back(std::move(swipe_and_emit));
-    swipe_actions.emplace_back(std::move(liftoff_and_ack));
 
-    auto cancel = [this]() { this->handleCancelledGesture(); };
+            // cancel event already sent to windows on 3 finger down
+            this->emitCompletedGesture(gesture);
+        }
+    }
 
-    this->addTouchGesture(std::make_unique<wf::touch::gesture_t>(std::move(swipe_actions), []() {}, cancel));
+    if (status == wf::touch::ACTION_STATUS_CANCELLED) {
+        this->handleCancelledGesture();
+    }
 }
 
-void IGestureManager::addMultiFingerTap(double base_finger_slip, const float* sensitivity, const int64_t* timeout) {
-    auto tap = std::make_unique<MultiFingerTap>(base_finger_slip, sensitivity, timeout);
-
-    std::vector<std::unique_ptr<wf::touch::gesture_action_t>> tap_actions;
-    tap_actions.emplace_back(std::move(tap));
-
-    auto ack = [this]() {
+void IGestureManager::onStage(
+    TapRecognizer& r, size_t stage, wf::touch::action_status_t status, const wf::touch::gesture_event_t& ev
+) {
+    if (r.get_status() == wf::touch::GESTURE_STATUS_COMPLETED) {
         const auto gesture = CompletedGestureEvent{
             .type         = GestureType::TAP,
             .direction    = 0,
-            .finger_count = static_cast<uint32_t>(this->m_sGestureState.fingers.size()),
+            .finger_count = static_cast<uint32_t>(this->m_sGestureState.size()),
         };
         if (this->emitCompletedGesture(gesture)) {
             this->cancelTouchEventsOnAllWindows();
         }
-    };
-    auto cancel = [this]() { this->handleCancelledGesture(); };
-
-    this->addTouchGesture(std::make_unique<wf::touch::gesture_t>(std::move(tap_actions), ack, cancel));
+    } else if (status == wf::touch::ACTION_STATUS_CANCELLED) {
+        this->handleCancelledGesture();
+    }
 }
 
-void IGestureManager::addLongPress(double base_finger_slip, const float* sensitivity, const int64_t* delay) {
-    auto long_press_and_emit = std::make_unique<OnCompleteAction>(
-        std::make_unique<LongPress>(
-            base_finger_slip, sensitivity, delay,
-            [this](uint32_t current_time, uint32_t delay) { this->updateLongPressTimer(current_time, delay); }
-        ),
-        [this](uint32_t time, bool cancelled) {
-            if (cancelled || this->activeDragGesture.has_value()) {
-                return;
-            }
+void IGestureManager::onStage(
+    LongPressRecognizer& r, size_t stage, wf::touch::action_status_t status, const wf::touch::gesture_event_t& ev
+) {
+    if (stage == 0 && status == wf::touch::ACTION_STATUS_COMPLETED) {
+        if (!this->activeDragGesture.has_value()) {
             const auto gesture = DragGestureEvent{
-                .time         = time,
+                .time         = ev.time,
                 .type         = GestureType::LONG_PRESS,
                 .direction    = 0,
-                .finger_count = static_cast<uint32_t>(this->m_sGestureState.fingers.size())
+                .finger_count = static_cast<uint32_t>(this->m_sGestureState.size())
             };
 
             const auto gesture1 = CompletedGestureEvent{
                 .type         = GestureType::LONG_PRESS,
                 .direction    = 0,
-                .finger_count = static_cast<uint32_t>(this->m_sGestureState.fingers.size()),
+                .finger_count = static_cast<uint32_t>(this->m_sGestureState.size()),
             };
 
             bool handled = this->emitDragGesture(gesture) || this->emitCompletedGesture(gesture1);
@@ -269,173 +519,117 @@ void IGestureManager::addLongPress(double base_finger_slip, const float* sensiti
                 this->cancelTouchEventsOnAllWindows();
             }
         }
-    );
-
-    auto lift_all_and_ack =
-        std::make_unique<OnCompleteAction>(std::make_unique<LiftAll>(), [this](uint32_t time, bool _) {
-            if (this->activeDragGesture.has_value()) {
-                DragGestureEvent gev = {this->activeDragGesture.value()};
-                gev.time             = time;
-                this->emitDragGestureEnd(gev);
-                return;
-            };
-        });
-
-    std::vector<std::unique_ptr<wf::touch::gesture_action_t>> long_press_actions;
-    long_press_actions.emplace_back(std::move(long_press_and_emit));
-    long_press_actions.emplace_back(std::move(lift_all_and_ack));
+    } else if (stage == 1 && stageEnded(status)) {
+        if (this->activeDragGesture.has_value()) {
+            DragGestureEvent gev = {this->activeDragGesture.value()};
+            gev.time             = ev.time;
+            this->emitDragGestureEnd(gev);
+        }
+    }
 
-    auto cancel = [this]() {
-        this->stopLongPressTimer();
+    if (status == wf::touch::ACTION_STATUS_CANCELLED) {
         this->handleCancelledGesture();
-    };
-
-    this->addTouchGesture(std::make_unique<wf::touch::gesture_t>(std::move(long_press_actions), []() {}, cancel));
+    }
 }
 
-void IGestureManager::addEdgeSwipeGesture(
-    double base_threshold, double base_finger_slip, const float* sensitivity, const int64_t* timeout,
-    const long int* edge_margin
+void IGestureManager::onStage(
+    EdgeSwipeRecognizer& r, size_t stage, wf::touch::action_status_t status, const wf::touch::gesture_event_t& ev
 ) {
-    auto edge     = std::make_unique<CMultiAction>(base_threshold, base_finger_slip, sensitivity, timeout);
-    auto edge_ptr = edge.get();
-    auto edge_drag_begin =
-        std::make_unique<OnCompleteAction>(std::move(edge), [=, this](uint32_t time, bool cancelled) {
-            if (cancelled || this->activeDragGesture)
-                return;
+    const auto& edge = std::get<0>(r.stages);
 
-            auto origin_edges = this->find_swipe_edges(m_sGestureState.get_center().origin, *edge_margin);
+    if (stage == 0 && status == wf::touch::ACTION_STATUS_COMPLETED && !this->activeDragGesture) {
+        auto origin_edges = this->find_swipe_edges(this->m_sTouchMetrics.center().origin, *r.kind.edge_margin);
 
-            if (origin_edges == 0) {
-                return;
-            }
-            auto direction = edge_ptr->target_direction;
+        if (origin_edges != 0) {
+            auto direction = edge.target_direction;
             auto gesture   = DragGestureEvent{
-                  .time         = time,
+                  .time         = ev.time,
                   .type         = GestureType::EDGE_SWIPE,
                   .direction    = direction,
-                  .finger_count = static_cast<uint32_t>(edge_ptr->finger_count),
+                  .finger_count = static_cast<uint32_t>(edge.finger_count),
                   .edge_origin  = origin_edges
             };
             auto completed = CompletedGestureEvent{
                 .type         = GestureType::EDGE_SWIPE,
                 .direction    = direction,
-                .finger_count = static_cast<uint32_t>(edge_ptr->finger_count),
+                .finger_count = static_cast<uint32_t>(edge.finger_count),
                 .edge_origin  = origin_edges
             };
             if (this->emitDragGesture(gesture) || this->reserveCompletedGesture(completed)) {
                 this->cancelTouchEventsOnAllWindows();
             }
-        });
-    auto release_and_ack = std::make_unique<OnCompleteAction>(
-        std::make_unique<wf::touch::touch_action_t>(1, false), [edge_ptr, edge_margin, this](uint32_t time, bool _) {
-            auto origin_edges = find_swipe_edges(m_sGestureState.get_center().origin, *edge_margin);
-            auto direction    = edge_ptr->target_direction;
-            auto dragEvent    = DragGestureEvent{
-                   .time         = time,
-                   .type         = GestureType::EDGE_SWIPE,
-                   .direction    = direction,
-                   .finger_count = static_cast<uint32_t>(edge_ptr->finger_count),
-                   .edge_origin  = origin_edges,
-            };
-
-            if (this->emitDragGestureEnd(dragEvent)) {
-                return;
-            }
-
-            if (origin_edges == 0) {
-                return;
-            }
+        }
+    } else if (stage == 1 && stageEnded(status)) {
+        auto origin_edges = find_swipe_edges(this->m_sTouchMetrics.center().origin, *r.kind.edge_margin);
+        auto direction    = edge.target_direction;
+        auto dragEvent    = DragGestureEvent{
+               .time         = ev.time,
+               .type         = GestureType::EDGE_SWIPE,
+               .direction    = direction,
+               .finger_count = static_cast<uint32_t>(edge.finger_count),
+               .edge_origin  = origin_edges,
+        };
 
+        if (!this->emitDragGestureEnd(dragEvent) && origin_edges != 0) {
             auto event = CompletedGestureEvent{
                 .type         = GestureType::EDGE_SWIPE,
                 .direction    = direction,
-                .finger_count = static_cast<uint32_t>(edge_ptr->finger_count),
+                .finger_count = static_cast<uint32_t>(edge.finger_count),
                 .edge_origin  = origin_edges,
             };
 
             this->emitCompletedGesture(event);
         }
-    );
-    // TODO do I really need this:
-    // edge->set_move_tolerance(SWIPE_INCORRECT_DRAG_TOLERANCE * *sensitivity);
-
-    // The release action needs longer duration to handle the case where the
-    // gesture is actually longer than the max distance.
-    // TODO make this adjustable:
-    // edge_release->set_duration(GESTURE_BASE_DURATION * 1.5 * *sensitivity);
-
-    std::vector<std::unique_ptr<wf::touch::gesture_action_t>> edge_swipe_actions;
-    edge_swipe_actions.emplace_back(std::move(edge_drag_begin));
-    edge_swipe_actions.emplace_back(std::move(release_and_ack));
-
-    auto cancel = [this]() { this->handleCancelledGesture(); };
+    }
 
-    auto gesture = std::make_unique<wf::touch::gesture_t>(std::move(edge_swipe_actions), []() {}, cancel);
-    this->addTouchGesture(std::move(gesture));
+    if (status == wf::touch::ACTION_STATUS_CANCELLED) {
+        this->handleCancelledGesture();
+    }
 }
 
-// TODO: timeouts (also in other gestures)
-void IGestureManager::addPinchGesture(double base_threshold, const float* sensitivity, const int64_t* timeout) {
-    auto pinch_begin = std::make_unique<PinchAction>(base_threshold, sensitivity);
-
-    auto pinch_wrapper =
-        std::make_unique<OnCompleteAction>(std::move(pinch_begin), [this](uint32_t time, bool cancelled) {
-            if (cancelled || this->activeDragGesture)
-                return;
-
-            GestureDirection dir =
-                this->m_sGestureState.get_pinch_scale() < 1.0 ? GESTURE_DIRECTION_OUT : GESTURE_DIRECTION_IN;
-
-            auto gesture = DragGestureEvent{
-                .time         = time,
-                .type         = GestureType::PINCH,
-                .direction    = dir,
-                .finger_count = static_cast<uint32_t>(this->m_sGestureState.fingers.size()),
-                .edge_origin  = 0,
-            };
-            if (this->emitDragGesture(gesture)) {
-                this->cancelTouchEventsOnAllWindows();
-                return;
-            }
-
+void IGestureManager::onStage(
+    PinchRecognizer& r, size_t stage, wf::touch::action_status_t status, const wf::touch::gesture_event_t& ev
+) {
+    if (stage == 0 && status == wf::touch::ACTION_STATUS_COMPLETED && !this->activeDragGesture) {
+        GestureDirection dir = this->m_sTouchMetrics.pinchScale() < 1.0 ? GESTURE_DIRECTION_OUT : GESTURE_DIRECTION_IN;
+
+        auto gesture = DragGestureEvent{
+            .time         = ev.time,
+            .type         = GestureType::PINCH,
+            .direction    = dir,
+            .finger_count = static_cast<uint32_t>(this->m_sGestureState.size()),
+            .edge_origin  = 0,
+        };
+        if (this->emitDragGesture(gesture)) {
+            this->cancelTouchEventsOnAllWindows();
+        } else {
             auto completed = CompletedGestureEvent{
                 .type         = GestureType::PINCH,
                 .direction    = dir,
-                .finger_count = static_cast<uint32_t>(this->m_sGestureState.fingers.size()),
+                .finger_count = static_cast<uint32_t>(this->m_sGestureState.size()),
             };
             if (this->reserveCompletedGesture(completed)) {
                 this->cancelTouchEventsOnAllWindows();
             }
-        });
-    auto release = std::make_unique<LiftoffAction>();
-
-    std::vector<std::unique_ptr<wf::touch::gesture_action_t>> pinch_actions;
-    pinch_actions.emplace_back(std::move(pinch_wrapper));
-    pinch_actions.emplace_back(std::move(release));
+        }
+    }
 
-    auto ack = [this]() {
+    if (r.get_status() == wf::touch::GESTURE_STATUS_COMPLETED) {
         if (!this->activeDragGesture.has_value()) {
-            auto dir   = this->m_sGestureState.get_pinch_scale() < 1.0 ? GESTURE_DIRECTION_OUT : GESTURE_DIRECTION_IN;
+            auto dir   = this->m_sTouchMetrics.pinchScale() < 1.0 ? GESTURE_DIRECTION_OUT : GESTURE_DIRECTION_IN;
             auto event = CompletedGestureEvent{
                 .type         = GestureType::PINCH,
                 .direction    = dir,
-                .finger_count = static_cast<uint32_t>(this->m_sGestureState.fingers.size()),
+                .finger_count = static_cast<uint32_t>(this->m_sGestureState.size()),
                 .edge_origin  = 0,
             };
 
             // already sent cancel event to windows in drag begin
             this->emitCompletedGesture(event);
-            return;
+        } else {
+            this->emitDragGestureEnd(this->activeDragGesture.value());
         }
-
-        auto active = this->activeDragGesture.value();
-        if (this->emitDragGestureEnd(active)) {
-            return;
-        }
-    };
-    auto cancel = [this]() { this->handleCancelledGesture(); };
-
-    auto gesture = std::make_unique<wf::touch::gesture_t>(std::move(pinch_actions), ack, cancel);
-    this->addTouchGesture(std::move(gesture));
+    } else if (status == wf::touch::ACTION_STATUS_CANCELLED) {
+        this->handleCancelledGesture();
+    }
 }
@@ -1,30 +1,114 @@
 #pragma once
 
 #include "CompletedGesture.hpp"
+#include "Deadlines.hpp"
 #include "DragGesture.hpp"
 #include "Logger.hpp"
+#include "Recognizer.hpp"
 #include "Shared.hpp"
+#include "TouchHistory.hpp"
+#include "TouchMetrics.hpp"
+#include "TouchState.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <memory>
 #include <optional>
+#include <vector>
 #include <wayfire/touch/touch.hpp>
 
 struct SMonitorArea {
     double x, y, w, h;
 };
 
+// Opaque reference to the handlers found by findCompletedGesture(). It is handed
+// back to handleCompletedGesture() so the handlers don't have to be looked up twice.
+using BindHandle = uint64_t;
+
+// Which (gesture type, finger count) combinations have something that consumes them. Recognizers
+// of gestures that can no longer be consumed are dropped from the touch sequence.
+struct GestureDemand {
+    static constexpr uint32_t MAX_FINGERS = 63;
+
+    // per GestureType, bit n is set if n-finger gestures are consumed
+    std::array<uint64_t, 5> fingers = {};
+
+    // demands every gesture, used until told otherwise
+    static GestureDemand all() {
+        GestureDemand demand;
+        demand.fingers.fill(~uint64_t{0});
+        return demand;
+    }
+
+    // @finger_count of 0 means any number of fingers
+    void add(GestureType type, uint32_t finger_count) {
+        this->fingers[static_cast<size_t>(type)] |=
+            finger_count == 0 ? ~uint64_t{0} : uint64_t{1} << std::min(finger_count, MAX_FINGERS);
+    }
+
+    // whether a gesture that currently has @finger_count fingers can still turn into a consumed
+    // one, fingers can only be added during a gesture
+    bool reachable(GestureType type, uint32_t finger_count) const {
+        return (this->fingers[static_cast<size_t>(type)] >> std::min(finger_count, MAX_FINGERS)) != 0;
+    }
+
+    // whether any gesture with exactly @finger_count fingers is consumed
+    bool wantsAny(uint32_t finger_count) const {
+        return std::ranges::any_of(this->fingers, [finger_count](uint64_t mask) {
+            return (mask >> std::min(finger_count, MAX_FINGERS)) & 1;
+        });
+    }
+
+    bool operator==(const GestureDemand&) const = default;
+};
+
 /*
  * Interface; there's only @CGestures and the mock gesture manager for testing
  * that implements this
  *
- * New gesture_t are added with @addTouchGesture(). Callbacks are triggered
- * during updateGestures if all actions within a geture_t is completed (actions
- * are chained serially, i.e. one action must be "completed" before the next
- * can start "running")
+ * Recognizers (see Recognizer.hpp) are added with @addRecognizer(), usually
+ * through one of the add*Gesture() helpers. Gesture events are emitted from
+ * the onStage() overloads during updateGestures whenever a stage of a
+ * recognizer completes or gets cancelled (stages are chained serially, i.e.
+ * one stage must be "completed" before the next can start "running")
  */
 class IGestureManager {
   public:
     IGestureManager(std::unique_ptr<Logger> logger) : logger(std::move(logger)) {}
     virtual ~IGestureManager() {}
+
+    struct PromisedGesture {
+        CompletedGestureEvent event;
+        BindHandle binds;
+    };
+
+    // Everything the manager tracks about one touch sequence. Managers that follow several
+    // touch devices at once keep one per device that is not being processed right now and
+    // exchange it with swapSession(), the device being processed lives in the manager itself.
+    struct Session {
+        TouchState gestureState;
+        TouchState pendingState;
+        TouchMetrics touchMetrics;
+        TouchMetrics pendingMetrics;
+        TouchHistory touchHistory;
+        std::optional<wf::touch::gesture_event_t> queuedMotion;
+        std::vector<Recognizer> recognizers;
+        std::vector<size_t> liveGestures;
+        std::optional<DragGestureEvent> activeDragGesture;
+        std::optional<PromisedGesture> promisedCompletedGesture;
+        DeadlineQueue deadlines;
+        std::vector<std::optional<uint32_t>> registeredDeadlines;
+        std::optional<uint32_t> armedDeadline;
+        bool inhibitTouchEvents = false;
+        bool gestureTriggered   = false;
+    };
+
+    // a session that recognizes the same gestures as this manager, with no fingers down
+    Session newSession() const;
+    // gives @session this manager's recognizers, e.g. after they were rebuilt. Gestures in progress
+    // in @session are dropped, like clearRecognizers() does
+    void adoptRecognizers(Session& session) const;
+    void swapSession(Session& session);
     // @return whether this touch event should be blocked from forwarding to the
     // client window/surface
     bool onTouchDown(const wf::touch::gesture_event_t&);
@@ -37,7 +121,28 @@ class IGestureManager {
     // client window/surface
     bool onTouchMove(const wf::touch::gesture_event_t&);
 
-    void addTouchGesture(std::unique_ptr<wf::touch::gesture_t> gesture);
+    // Applies a motion event to the touch state without running the recognizers, they see all
+    // motion queued since the last flush at once on flushMotion() or on the next touch event.
+    // Used to process every finger of an input frame together.
+    void queueMotion(const wf::touch::gesture_event_t&);
+
+    // runs the recognizers for the queued motion, if any
+    // @return whether the queued events should be blocked from forwarding to the
+    // client window/surface
+    bool flushMotion();
+
+    bool hasQueuedMotion() const {
+        return m_sQueuedMotion.has_value();
+    }
+
+    // resolves the recognizers whose deadline passed at @time, the event time the timer
+    // armed through updateTimeoutTimer() was meant for.
+    // @return whether further touch events should be blocked from forwarding to the
+    // client window/surface
+    bool onTimeout(uint32_t time);
+
+    void addRecognizer(Recognizer recognizer);
+    void clearRecognizers();
     void addMultiFingerGesture(
         double base_threshold, double base_finger_slip, const float* sensitivity, const int64_t* timeout
     );
@@ -49,6 +154,11 @@ class IGestureManager {
     );
     void addPinchGesture(double base_threshold, const float* sensitivity, const int64_t* timeout);
 
+    // recent positions and velocities of the fingers, up to the event being processed
+    const TouchHistory& touchHistory() const {
+        return m_sTouchHistory;
+    }
+
     std::optional<DragGestureEvent> getActiveDragGesture() const {
         return activeDragGesture;
     }
@@ -59,9 +169,31 @@ class IGestureManager {
         return inhibitTouchEvents;
     };
 
+    // takes effect at the start of the next touch sequence
+    void setGestureDemand(const GestureDemand& demand) {
+        m_sGestureDemand = demand;
+    }
+
+    // number of recognizers that can still complete in the current touch sequence
+    size_t liveGestureCount() const {
+        return m_vLiveGestures.size();
+    }
+
+    // whether a recognizer of @type can still complete in the current touch sequence
+    bool hasLiveGesture(GestureType type) const;
+
+    // progress/status of the recognizer that was added @index-th
+    double getGestureProgress(size_t index) const;
+    wf::touch::gesture_status_t getGestureStatus(size_t index) const;
+
   protected:
-    std::vector<std::unique_ptr<wf::touch::gesture_t>> m_vGestures;
-    wf::touch::gesture_state_t m_sGestureState;
+    // stored by value so a touch event walks a single contiguous array
+    std::vector<Recognizer> m_vRecognizers;
+
+    const GestureDemand& getGestureDemand() const {
+        return m_sGestureDemand;
+    }
+    TouchState m_sGestureState;
 
     GestureDirection find_swipe_edges(wf::touch::point_t point, int edge_margin);
     virtual SMonitorArea getMonitorArea() const = 0;
@@ -69,9 +201,10 @@ class IGestureManager {
     // checks if the gesture event has a corresponding handler. longpress skips this
     // and calls handleCompletedGesture directly because it's CompletedGestureEvent
     // is emitted at drag begin.
-    virtual bool findCompletedGesture(const CompletedGestureEvent& gev) const = 0;
+    virtual std::optional<BindHandle> findCompletedGesture(const CompletedGestureEvent& gev) const = 0;
     // handles gesture events and returns whether or not the event is used.
-    virtual bool handleCompletedGesture(const CompletedGestureEvent& gev) = 0;
+    // @binds is the result of an earlier findCompletedGesture() for the same event, if any
+    virtual bool handleCompletedGesture(const CompletedGestureEvent& gev, std::optional<BindHandle> binds) = 0;
 
     // called at the start of drag evetns and returns whether or not the event is used.
     virtual bool handleDragGesture(const DragGestureEvent& gev) = 0;
@@ -85,17 +218,39 @@ class IGestureManager {
     // this function should cleanup after drag gestures
     virtual void handleCancelledGesture() = 0;
 
-    virtual void updateLongPressTimer(uint32_t current_time, uint32_t delay) = 0;
-    virtual void stopLongPressTimer()                                        = 0;
+    // asks for onTimeout(@deadline) to be called once @deadline passed, nullopt disarms the timer.
+    // @current_time is the time of the event that is being processed
+    virtual void updateTimeoutTimer(uint32_t current_time, std::optional<uint32_t> deadline) = 0;
 
     virtual void debugLog(const std::string& msg) {};
 
   private:
     std::unique_ptr<Logger> logger;
-    bool inhibitTouchEvents;
-    bool gestureTriggered; // A drag/completed gesture is triggered
+    bool inhibitTouchEvents = false;
+    bool gestureTriggered   = false; // A drag/completed gesture is triggered
     std::optional<DragGestureEvent> activeDragGesture;
-    std::optional<CompletedGestureEvent> promisedCompletedGesture;
+    std::optional<PromisedGesture> promisedCompletedGesture;
+    // indices into m_vRecognizers of recognizers that have not been cancelled or completed
+    // since the start of the touch sequence, in the order they were added
+    std::vector<size_t> m_vLiveGestures;
+    GestureDemand m_sGestureDemand = GestureDemand::all();
+
+    TouchMetrics m_sTouchMetrics;
+    // m_sGestureState with the event that is being processed already applied; this is what
+    // recognizers see, callbacks still see m_sGestureState
+    TouchState m_sPendingState;
+    // metrics of m_sPendingState, read by recognizer actions
+    TouchMetrics m_sPendingMetrics;
+    // samples of m_sPendingState
+    TouchHistory m_sTouchHistory;
+    // last motion event given to queueMotion() since the last flush
+    std::optional<wf::touch::gesture_event_t> m_sQueuedMotion;
+    // deadlines of the live recognizers, see Pipeline::deadline()
+    DeadlineQueue m_sDeadlines;
+    // the deadline of each recognizer that is in m_sDeadlines, to push only the ones that changed
+    std::vector<std::optional<uint32_t>> m_vRegisteredDeadlines;
+    // the deadline last given to updateTimeoutTimer()
+    std::optional<uint32_t> m_iArmedDeadline;
 
     // this function is called when needed to send "cancel touch" events to
     // client windows/surfaces
@@ -109,5 +264,27 @@ class IGestureManager {
     bool emitDragGestureEnd(const DragGestureEvent& gev);
 
     void updateGestures(const wf::touch::gesture_event_t&);
+    // computes the metrics recognizers will see for @ev
+    void prepareEvent(const wf::touch::gesture_event_t& ev);
+    // applies @ev to m_sGestureState
+    void commitEvent(const wf::touch::gesture_event_t& ev);
+    bool isGestureDemanded(size_t index) const;
+    // queues the deadline of recognizer @index if it changed
+    void registerDeadline(size_t index);
+    // forgets the deadline of recognizer @index, for recognizers that leave the live set
+    void dropDeadline(size_t index);
+    bool isCurrentDeadline(const DeadlineQueue::Entry& entry) const;
+    // forgets all deadlines, used when a touch sequence starts
+    void clearDeadlines();
+    void updateTimer(uint32_t current_time);
+
+    // called after every update of a recognizer with the stage that handled @ev and its result
+    void onStage(SwipeRecognizer& r, size_t stage, wf::touch::action_status_t, const wf::touch::gesture_event_t& ev);
+    void onStage(TapRecognizer& r, size_t stage, wf::touch::action_status_t, const wf::touch::gesture_event_t& ev);
+    void
+    onStage(LongPressRecognizer& r, size_t stage, wf::touch::action_status_t, const wf::touch::gesture_event_t& ev);
+    void
+    onStage(EdgeSwipeRecognizer& r, size_t stage, wf::touch::action_status_t, const wf::touch::gesture_event_t& ev);
+    void onStage(PinchRecognizer& r, size_t stage, wf::touch::action_status_t, const wf::touch::gesture_event_t& ev);
     void cancelTouchEventsOnAllWindows();
 };
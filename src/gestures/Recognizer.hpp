@@ -0,0 +1,167 @@
+#pragma once
+#include "Actions.hpp"
+#include "CompletedGesture.hpp"
+#include "TouchMetrics.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <variant>
+#include <wayfire/touch/touch.hpp>
+
+/*
+ * A recognizer runs a fixed sequence of stages (see Actions.hpp) one after
+ * another: a stage must complete before the next one starts receiving events,
+ * and the whole recognizer is cancelled as soon as one of its stages cancels.
+ *
+ * Stages are stored by value and dispatched statically, the gesture manager
+ * reacts to their results through an overload for each @Kind.
+ */
+template <typename Kind, typename... Stages>
+class Pipeline {
+  public:
+    static constexpr size_t STAGE_COUNT = sizeof...(Stages);
+
+    Kind kind;
+    std::tuple<Stages...> stages;
+
+    Pipeline(Kind kind, Stages... stages) : kind(kind), stages(std::move(stages)...) {}
+
+    void reset(uint32_t time) {
+        this->current = 0;
+        this->status  = wf::touch::GESTURE_STATUS_RUNNING;
+        std::get<0>(this->stages).reset(time);
+    }
+
+    // feeds @event to the current stage, then calls
+    // @onStage(pipeline, stage index, stage result, event)
+    template <typename Handler>
+    void update(const TouchMetrics& metrics, const wf::touch::gesture_event_t& event, Handler&& onStage) {
+        if (this->status != wf::touch::GESTURE_STATUS_RUNNING) {
+            return;
+        }
+
+        const size_t stage = this->current;
+        const auto result  = this->updateStage(metrics, event, std::index_sequence_for<Stages...>{});
+        this->advance(result, event.time);
+
+        onStage(*this, stage, result, event);
+    }
+
+    // event time at which the current stage resolves on its own, see Actions.hpp
+    std::optional<uint32_t> deadline() const {
+        if (this->status != wf::touch::GESTURE_STATUS_RUNNING) {
+            return std::nullopt;
+        }
+
+        return this->stageDeadline(std::index_sequence_for<Stages...>{});
+    }
+
+    // resolves the current stage because its deadline passed at @time, then calls @onStage like
+    // update() does. The event given to @onStage only carries the time.
+    template <typename Handler>
+    void timeout(uint32_t time, Handler&& onStage) {
+        if (this->status != wf::touch::GESTURE_STATUS_RUNNING) {
+            return;
+        }
+
+        const size_t stage = this->current;
+        const auto result  = this->timeoutStage(std::index_sequence_for<Stages...>{});
+        this->advance(result, time);
+
+        const wf::touch::gesture_event_t event = {.type = wf::touch::EVENT_TYPE_MOTION, .time = time};
+        onStage(*this, stage, result, event);
+    }
+
+    wf::touch::gesture_status_t get_status() const {
+        return this->status;
+    }
+
+    double get_progress() const {
+        if (this->status == wf::touch::GESTURE_STATUS_CANCELLED) {
+            return 0.0;
+        }
+
+        return 1.0 * this->current / STAGE_COUNT;
+    }
+
+  private:
+    size_t current                    = 0;
+    wf::touch::gesture_status_t status = wf::touch::GESTURE_STATUS_CANCELLED;
+
+    void advance(wf::touch::action_status_t result, uint32_t time) {
+        switch (result) {
+            case wf::touch::ACTION_STATUS_RUNNING:
+                break;
+            case wf::touch::ACTION_STATUS_CANCELLED:
+                this->status = wf::touch::GESTURE_STATUS_CANCELLED;
+                break;
+            case wf::touch::ACTION_STATUS_COMPLETED:
+            case wf::touch::ACTION_STATUS_ALREADY_COMPLETED:
+                if (++this->current < STAGE_COUNT) {
+                    this->resetStage(time, std::index_sequence_for<Stages...>{});
+                } else {
+                    this->status = wf::touch::GESTURE_STATUS_COMPLETED;
+                }
+                break;
+        }
+    }
+
+    template <size_t... I>
+    wf::touch::action_status_t
+    updateStage(const TouchMetrics& metrics, const wf::touch::gesture_event_t& event, std::index_sequence<I...>) {
+        auto result = wf::touch::ACTION_STATUS_RUNNING;
+        ((I == this->current && (result = std::get<I>(this->stages).update_state(metrics, event), true)) || ...);
+        return result;
+    }
+
+    template <size_t... I>
+    void resetStage(uint32_t time, std::index_sequence<I...>) {
+        ((I == this->current && (std::get<I>(this->stages).reset(time), true)) || ...);
+    }
+
+    template <size_t... I>
+    std::optional<uint32_t> stageDeadline(std::index_sequence<I...>) const {
+        std::optional<uint32_t> deadline;
+        ((I == this->current && (deadline = std::get<I>(this->stages).deadline(), true)) || ...);
+        return deadline;
+    }
+
+    template <size_t... I>
+    wf::touch::action_status_t timeoutStage(std::index_sequence<I...>) {
+        auto result = wf::touch::ACTION_STATUS_RUNNING;
+        ((I == this->current && (result = std::get<I>(this->stages).on_timeout(), true)) || ...);
+        return result;
+    }
+};
+
+struct SwipeKind {
+    static constexpr GestureType TYPE = GestureType::SWIPE;
+};
+
+struct EdgeSwipeKind {
+    static constexpr GestureType TYPE = GestureType::EDGE_SWIPE;
+    const long* edge_margin;
+};
+
+struct TapKind {
+    static constexpr GestureType TYPE = GestureType::TAP;
+};
+
+struct LongPressKind {
+    static constexpr GestureType TYPE = GestureType::LONG_PRESS;
+};
+
+struct PinchKind {
+    static constexpr GestureType TYPE = GestureType::PINCH;
+};
+
+using SwipeRecognizer     = Pipeline<SwipeKind, CMultiAction, LiftoffAction>;
+using EdgeSwipeRecognizer = Pipeline<EdgeSwipeKind, CMultiAction, LiftoffAction>;
+using TapRecognizer       = Pipeline<TapKind, MultiFingerTap>;
+using LongPressRecognizer = Pipeline<LongPressKind, LongPress, LiftAll>;
+using PinchRecognizer     = Pipeline<PinchKind, PinchAction, LiftoffAction>;
+
+using Recognizer =
+    std::variant<SwipeRecognizer, EdgeSwipeRecognizer, TapRecognizer, LongPressRecognizer, PinchRecognizer>;
@@ -28,3 +28,33 @@ std::string stringifyDirection(GestureDirection direction) {
 
     return bind;
 }
+
+std::optional<GestureDirection> parseDirection(std::string_view s) {
+    GestureDirection direction = 0;
+    for (const char c : s) {
+        switch (c) {
+            case 'l':
+                direction |= GESTURE_DIRECTION_LEFT;
+                break;
+            case 'r':
+                direction |= GESTURE_DIRECTION_RIGHT;
+                break;
+            case 'u':
+                direction |= GESTURE_DIRECTION_UP;
+                break;
+            case 'd':
+                direction |= GESTURE_DIRECTION_DOWN;
+                break;
+            case 'i':
+                direction |= GESTURE_DIRECTION_IN;
+                break;
+            case 'o':
+                direction |= GESTURE_DIRECTION_OUT;
+                break;
+            default:
+                return std::nullopt;
+        }
+    }
+
+    return direction;
+}
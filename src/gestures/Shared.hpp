@@ -1,6 +1,8 @@
 #pragma once
 #include <cstdint>
+#include <optional>
 #include <string>
+#include <string_view>
 
 // Swipe params
 constexpr static double SWIPE_INCORRECT_DRAG_TOLERANCE = 100;
@@ -25,3 +27,5 @@ enum TouchGestureDirection {
 };
 
 std::string stringifyDirection(GestureDirection direction);
+// reverse of stringifyDirection, returns std::nullopt on unknown characters
+std::optional<GestureDirection> parseDirection(std::string_view s);
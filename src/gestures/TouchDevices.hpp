@@ -0,0 +1,73 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+// The device of every touch point that is down. Touch IDs are only unique per device, but touch up
+// and motion events don't carry their device, so listeners on the devices themselves leave a hint
+// about which one emits the next event.
+//
+// Whether the hints arrive before the events is up to the order the device's listeners run in. It is
+// found out from touch down events, which do carry their device. Until a hint matched one of them,
+// up and motion events go to the newest touch point with their ID.
+template <class Device> class TouchDevices {
+  public:
+    // @device is about to emit the event of touch point @id at @time
+    void hint(const Device& device, int32_t id, uint32_t time) {
+        this->pending = SHint{.device = device, .id = id, .time = time};
+    }
+
+    void down(const Device& device, int32_t id, uint32_t time) {
+        if (this->matchesHint(id, time) && this->pending->device == device) {
+            this->hintsFirst = true;
+        }
+
+        this->up(device, id);
+        this->touches.emplace_back(device, id);
+    }
+
+    void up(const Device& device, int32_t id) {
+        std::erase_if(this->touches, [&](const auto& touch) { return touch.first == device && touch.second == id; });
+    }
+
+    // device of touch point @id for an up or motion event at @time, nullopt if no such point is down
+    std::optional<Device> resolve(int32_t id, uint32_t time) const {
+        if (this->hintsFirst && this->matchesHint(id, time) && this->isDown(this->pending->device, id)) {
+            return this->pending->device;
+        }
+
+        for (auto it = this->touches.rbegin(); it != this->touches.rend(); ++it) {
+            if (it->second == id) {
+                return it->first;
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    bool isDown(const Device& device, int32_t id) const {
+        for (const auto& [d, i] : this->touches) {
+            if (i == id && d == device) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+  private:
+    struct SHint {
+        Device device;
+        int32_t id;
+        uint32_t time;
+    };
+    std::optional<SHint> pending;
+    bool hintsFirst = false;
+    // few enough touch points that a linear search beats hashing
+    std::vector<std::pair<Device, int32_t>> touches;
+
+    bool matchesHint(int32_t id, uint32_t time) const {
+        return this->pending && this->pending->id == id && this->pending->time == time;
+    }
+};
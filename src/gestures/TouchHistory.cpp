@@ -0,0 +1,160 @@
+#include "TouchHistory.hpp"
+#include <cmath>
+
+void TouchHistory::Ring::push(const Sample& sample) {
+    if (this->count > 0) {
+        const auto& newest = this->samples[this->head];
+        if (newest.time == sample.time) {
+            this->samples[this->head] = sample;
+            return;
+        }
+
+        if (static_cast<uint32_t>(sample.time - newest.time) > STOPPED) {
+            this->count = 0;
+        }
+    }
+
+    this->head                = (this->head + 1) % CAPACITY;
+    this->samples[this->head] = sample;
+    if (this->count < CAPACITY) {
+        this->count++;
+    }
+}
+
+// Fits x(t) = b0 + b1 * t + b2 * t^2 to the samples, with t in milliseconds relative to the newest
+// sample, and returns b1, the slope at the newest sample. Falls back to a line when there are too
+// few samples for the quadratic fit to be well defined.
+wf::touch::point_t TouchHistory::Ring::velocity() const {
+    if (this->count < 2) {
+        return {0, 0};
+    }
+
+    const auto& newest = (*this)[0];
+
+    // sums of t^k, and of t^k times the position relative to the newest sample
+    double s0 = 0, s1 = 0, s2 = 0, s3 = 0, s4 = 0;
+    wf::touch::point_t p0{0, 0}, p1{0, 0}, p2{0, 0};
+    for (size_t age = 0; age < this->count; age++) {
+        const auto& sample = (*this)[age];
+        const auto elapsed = static_cast<uint32_t>(newest.time - sample.time);
+        if (elapsed > HORIZON) {
+            break;
+        }
+
+        const double t  = -static_cast<double>(elapsed);
+        const double tt = t * t;
+        const auto p    = sample.position - newest.position;
+
+        s0 += 1;
+        s1 += t;
+        s2 += tt;
+        s3 += tt * t;
+        s4 += tt * tt;
+        p0 += p;
+        p1 += p * t;
+        p2 += p * tt;
+    }
+
+    if (s0 >= 3) {
+        const double det = s0 * (s2 * s4 - s3 * s3) - s1 * (s1 * s4 - s3 * s2) + s2 * (s1 * s3 - s2 * s2);
+        if (std::abs(det) > 1e-9 * s0 * s2 * s4) {
+            const auto slope = (p1 * s4 - p2 * s3) * s0 - p0 * (s1 * s4 - s3 * s2) + (p2 * s1 - p1 * s2) * s2;
+            return slope / det * 1000.0;
+        }
+    }
+
+    const double det = s0 * s2 - s1 * s1;
+    if (det <= 0) {
+        return {0, 0};
+    }
+
+    return (p1 * s0 - p0 * s1) / det * 1000.0;
+}
+
+void TouchHistory::update(const wf::touch::gesture_event_t& ev, const TouchState& state) {
+    switch (ev.type) {
+        case wf::touch::EVENT_TYPE_TOUCH_DOWN: {
+            if (state.size() == 1) {
+                this->clear();
+            }
+
+            if (!state.find(ev.finger) || this->slot(ev.finger)) {
+                break;
+            }
+
+            const auto free = this->slot(-1);
+            if (!free) {
+                break;
+            }
+
+            this->ids[*free] = ev.finger;
+            this->fingers[*free].clear();
+            this->fingers[*free].push({.time = ev.time, .position = ev.pos});
+            break;
+        }
+        case wf::touch::EVENT_TYPE_TOUCH_UP:
+            if (const auto index = this->slot(ev.finger)) {
+                this->ids[*index] = -1;
+            }
+
+            // the centroid keeps its samples so the velocity at release can be read, unless the
+            // fingers rested before lifting
+            if (!this->centroid.empty() && static_cast<uint32_t>(ev.time - this->centroid[0].time) > STOPPED) {
+                this->centroid.clear();
+            }
+            this->centroidMoved = true;
+            return;
+        case wf::touch::EVENT_TYPE_MOTION:
+            if (const auto index = this->slot(ev.finger)) {
+                this->fingers[*index].push({.time = ev.time, .position = ev.pos});
+            }
+            break;
+    }
+
+    wf::touch::point_t center{0, 0};
+    for (size_t i = 0; i < state.size(); i++) {
+        center += wf::touch::point_t{state.currentX()[i], state.currentY()[i]};
+    }
+    center /= static_cast<double>(state.size());
+
+    // the centroid jumps when a finger comes or goes, that is not movement
+    if (ev.type == wf::touch::EVENT_TYPE_TOUCH_DOWN || this->centroidMoved) {
+        this->centroid.clear();
+        this->centroidMoved = false;
+    }
+    this->centroid.push({.time = ev.time, .position = center});
+}
+
+void TouchHistory::clear() {
+    this->ids = filledIds();
+    this->centroid.clear();
+    this->centroidMoved = false;
+}
+
+const TouchHistory::Ring* TouchHistory::finger(int id) const {
+    if (id < 0) {
+        return nullptr;
+    }
+
+    const auto index = this->slot(id);
+    return index ? &this->fingers[*index] : nullptr;
+}
+
+std::optional<wf::touch::point_t> TouchHistory::fingerVelocity(int id) const {
+    const auto* ring = this->finger(id);
+    if (!ring) {
+        return std::nullopt;
+    }
+
+    return ring->velocity();
+}
+
+std::optional<size_t> TouchHistory::slot(int id) const {
+    for (size_t i = 0; i < this->ids.size(); i++) {
+        if (this->ids[i] == id) {
+            return i;
+        }
+    }
+
+    return std::nullopt;
+}
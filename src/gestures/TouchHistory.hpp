@@ -0,0 +1,92 @@
+#pragma once
+#include "TouchState.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <wayfire/touch/touch.hpp>
+
+// Recent positions of every finger and of their centroid, to estimate how fast they move.
+//
+// Each finger keeps a ring of its last CAPACITY samples in a fixed slot, so recording a sample never
+// allocates. Velocities are a least squares fit over the samples of the last HORIZON milliseconds,
+// the same way Android's VelocityTracker does it.
+class TouchHistory {
+  public:
+    static constexpr size_t CAPACITY = 20;
+    // only samples this many milliseconds older than the newest one count towards the velocity
+    static constexpr uint32_t HORIZON = 100;
+    // a gap this long between two samples means the finger stopped, the older samples are dropped
+    static constexpr uint32_t STOPPED = 40;
+
+    struct Sample {
+        uint32_t time;
+        wf::touch::point_t position;
+    };
+
+    class Ring {
+      public:
+        // a sample with the same time as the newest one replaces it, so fingers that move
+        // in the same input frame leave one centroid sample
+        void push(const Sample& sample);
+        void clear() {
+            this->count = 0;
+        }
+
+        size_t size() const {
+            return this->count;
+        }
+
+        bool empty() const {
+            return this->count == 0;
+        }
+
+        // 0 is the newest sample
+        const Sample& operator[](size_t age) const {
+            return this->samples[(this->head + CAPACITY - age) % CAPACITY];
+        }
+
+        // in pixels per second, zero with fewer than two samples
+        wf::touch::point_t velocity() const;
+
+      private:
+        std::array<Sample, CAPACITY> samples;
+        // index of the newest sample
+        size_t head  = 0;
+        size_t count = 0;
+    };
+
+    // records @ev, @state must already have @ev applied
+    void update(const wf::touch::gesture_event_t& ev, const TouchState& state);
+    void clear();
+
+    // samples of the finger with touch ID @id, if it is down
+    const Ring* finger(int id) const;
+    // the centroid is not sampled on touch up, so right after a finger lifted it still describes
+    // the motion up to the release
+    const Ring& center() const {
+        return this->centroid;
+    }
+
+    // in pixels per second
+    std::optional<wf::touch::point_t> fingerVelocity(int id) const;
+    wf::touch::point_t centerVelocity() const {
+        return this->centroid.velocity();
+    }
+
+  private:
+    // touch ID of the finger in each slot, -1 if it is free
+    std::array<int, TouchState::MAX_FINGERS> ids = filledIds();
+    std::array<Ring, TouchState::MAX_FINGERS> fingers;
+    Ring centroid;
+    // a finger lifted since the last centroid sample
+    bool centroidMoved = false;
+
+    static constexpr std::array<int, TouchState::MAX_FINGERS> filledIds() {
+        std::array<int, TouchState::MAX_FINGERS> ids;
+        ids.fill(-1);
+        return ids;
+    }
+
+    std::optional<size_t> slot(int id) const;
+};
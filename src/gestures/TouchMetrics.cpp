@@ -0,0 +1,103 @@
+#include "TouchMetrics.hpp"
+#include <algorithm>
+#include <cmath>
+
+void TouchMetrics::update(const TouchState& state) {
+    const size_t n   = state.size();
+    const auto& ox   = state.originX();
+    const auto& oy   = state.originY();
+    const auto& cx   = state.currentX();
+    const auto& cy   = state.currentY();
+    this->count      = n;
+    this->incorrect_drag_valid = 0;
+
+    double sum_ox = 0.0, sum_oy = 0.0, sum_cx = 0.0, sum_cy = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        sum_ox += ox[i];
+        sum_oy += oy[i];
+        sum_cx += cx[i];
+        sum_cy += cy[i];
+    }
+
+    const double div = std::max<double>(1.0, n);
+    this->centroid   = {
+          .origin  = {sum_ox / div, sum_oy / div},
+          .current = {sum_cx / div, sum_cy / div},
+    };
+
+    // lengths are compared squared, sqrt is monotonic so the max is the same
+    double max_distance_sq = 0.0;
+    double max_tap_slip    = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        const double dx = cx[i] - ox[i];
+        const double dy = cy[i] - oy[i];
+        this->delta_x[i] = dx;
+        this->delta_y[i] = dy;
+        max_distance_sq  = std::max(max_distance_sq, dx * dx + dy * dy);
+        max_tap_slip     = std::max(max_tap_slip, dx * dx + dy + dy);
+    }
+    this->max_finger_distance = std::sqrt(max_distance_sq);
+    this->max_tap_slip        = max_tap_slip;
+
+    if (n == 0) {
+        this->pinch_scale    = 1.0;
+        this->rotation_angle = 0.0;
+        this->finger_span    = 0.0;
+        return;
+    }
+
+    const auto& c = this->centroid;
+    double old_dist = 0.0, new_dist = 0.0, angle_sum = 0.0;
+    // based on AOSP ScaleGestureDetector, see PinchAction
+    double dev_x = 0.0, dev_y = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        const double ax = ox[i] - c.origin.x, ay = oy[i] - c.origin.y;
+        const double bx = cx[i] - c.current.x, by = cy[i] - c.current.y;
+        old_dist += std::sqrt(ax * ax + ay * ay);
+        new_dist += std::sqrt(bx * bx + by * by);
+        dev_x += std::abs(bx);
+        dev_y += std::abs(by);
+    }
+
+    // kept apart so the loop above stays vectorizable
+    for (size_t i = 0; i < n; i++) {
+        const double ax = ox[i] - c.origin.x, ay = oy[i] - c.origin.y;
+        const double bx = cx[i] - c.current.x, by = cy[i] - c.current.y;
+        angle_sum += std::atan2(ax * by - ay * bx, ax * bx + ay * by);
+    }
+
+    this->pinch_scale    = new_dist / old_dist;
+    this->rotation_angle = angle_sum / n;
+    // diameter of the circle with a radius of the average deviation from the centroid
+    this->finger_span = std::hypot(dev_x / n * 2, dev_y / n * 2);
+}
+
+double TouchMetrics::maxIncorrectDragDistance(GestureDirection direction) const {
+    const auto index = direction & 0xF;
+    if (this->incorrect_drag_valid & (1 << index)) {
+        return this->incorrect_drag[index];
+    }
+
+    // same as finger_t::get_incorrect_drag_distance(): how far each finger is off the line through
+    // its origin in @direction, or its whole travel if it went backwards
+    const double nx = (direction & GESTURE_DIRECTION_LEFT) ? -1.0 : (direction & GESTURE_DIRECTION_RIGHT) ? 1.0 : 0.0;
+    const double ny = (direction & GESTURE_DIRECTION_UP) ? -1.0 : (direction & GESTURE_DIRECTION_DOWN) ? 1.0 : 0.0;
+    const double nn = nx * nx + ny * ny;
+
+    double max_sq = 0.0;
+    if (nn != 0.0) {
+        for (size_t i = 0; i < this->count; i++) {
+            const double dx     = this->delta_x[i];
+            const double dy     = this->delta_y[i];
+            const double amount = (dx * nx + dy * ny) / nn;
+            const double ex     = amount < 0 ? dx : dx - nx * amount;
+            const double ey     = amount < 0 ? dy : dy - ny * amount;
+            max_sq              = std::max(max_sq, ex * ex + ey * ey);
+        }
+    }
+
+    const double max = std::sqrt(max_sq);
+    this->incorrect_drag[index] = max;
+    this->incorrect_drag_valid |= 1 << index;
+    return max;
+}
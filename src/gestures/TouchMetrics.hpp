@@ -0,0 +1,73 @@
+#pragma once
+#include "Shared.hpp"
+#include "TouchState.hpp"
+#include <array>
+#include <cstdint>
+#include <wayfire/touch/touch.hpp>
+
+// Values derived from the fingers of a touch sequence, computed once per event and shared by every
+// recognizer instead of each of them walking the fingers again. The per finger loops run over the
+// arrays of TouchState so the compiler can vectorize them.
+//
+// Positions are relative to where each finger touched down, so these only describe actions that start
+// with the touch sequence, i.e. the first stage of a recognizer.
+class TouchMetrics {
+  public:
+    void update(const TouchState& state);
+
+    size_t fingerCount() const {
+        return this->count;
+    }
+
+    // centroid of all fingers
+    const wf::touch::finger_t& center() const {
+        return this->centroid;
+    }
+
+    // ratio of the current to the initial average distance of the fingers from the centroid,
+    // see gesture_state_t::get_pinch_scale()
+    double pinchScale() const {
+        return this->pinch_scale;
+    }
+
+    // average angle the fingers rotated around the centroid by, in radians,
+    // see gesture_state_t::get_rotation_angle()
+    double rotation() const {
+        return this->rotation_angle;
+    }
+
+    // average distance between fingers through the centroid
+    float span() const {
+        return this->finger_span;
+    }
+
+    // largest distance travelled by a finger
+    double maxFingerDistance() const {
+        return this->max_finger_distance;
+    }
+
+    // largest `dx * dx + dy + dy` of all fingers, the slip tap and long press have always been
+    // measured in. Kept as is so their thresholds keep their meaning.
+    double maxTapSlip() const {
+        return this->max_tap_slip;
+    }
+
+    // largest finger_t::get_incorrect_drag_distance() of all fingers, cached per direction
+    double maxIncorrectDragDistance(GestureDirection direction) const;
+
+  private:
+    size_t count = 0;
+    // current - origin of each finger, kept to answer maxIncorrectDragDistance()
+    alignas(32) TouchState::Lane delta_x;
+    alignas(32) TouchState::Lane delta_y;
+    wf::touch::finger_t centroid;
+    double pinch_scale         = 1.0;
+    double rotation_angle      = 0.0;
+    float finger_span          = 0.0;
+    double max_finger_distance = 0.0;
+    double max_tap_slip        = 0.0;
+
+    // indexed by swipe direction bits
+    mutable std::array<double, 16> incorrect_drag;
+    mutable uint16_t incorrect_drag_valid = 0;
+};
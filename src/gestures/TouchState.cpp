@@ -0,0 +1,74 @@
+#include "TouchState.hpp"
+
+std::optional<size_t> TouchState::find(int id) const {
+    for (size_t i = 0; i < this->count; i++) {
+        if (this->ids[i] == id) {
+            return i;
+        }
+    }
+
+    return std::nullopt;
+}
+
+void TouchState::update(const wf::touch::gesture_event_t& event) {
+    switch (event.type) {
+        case wf::touch::EVENT_TYPE_TOUCH_DOWN: {
+            auto index = this->find(event.finger);
+            if (!index) {
+                if (this->count == MAX_FINGERS) {
+                    return;
+                }
+
+                // keep the fingers sorted by ID
+                size_t at = 0;
+                while (at < this->count && this->ids[at] < event.finger) {
+                    at++;
+                }
+                this->insert(at, event.finger);
+                index = at;
+            }
+
+            this->origin_x[*index]  = event.pos.x;
+            this->origin_y[*index]  = event.pos.y;
+            this->current_x[*index] = event.pos.x;
+            this->current_y[*index] = event.pos.y;
+            break;
+        }
+        case wf::touch::EVENT_TYPE_MOTION:
+            if (const auto index = this->find(event.finger)) {
+                this->current_x[*index] = event.pos.x;
+                this->current_y[*index] = event.pos.y;
+            }
+            break;
+        case wf::touch::EVENT_TYPE_TOUCH_UP:
+            if (const auto index = this->find(event.finger)) {
+                this->erase(*index);
+            }
+            break;
+    }
+}
+
+void TouchState::insert(size_t index, int id) {
+    for (size_t i = this->count; i > index; i--) {
+        this->ids[i]       = this->ids[i - 1];
+        this->origin_x[i]  = this->origin_x[i - 1];
+        this->origin_y[i]  = this->origin_y[i - 1];
+        this->current_x[i] = this->current_x[i - 1];
+        this->current_y[i] = this->current_y[i - 1];
+    }
+
+    this->ids[index] = id;
+    this->count++;
+}
+
+void TouchState::erase(size_t index) {
+    for (size_t i = index + 1; i < this->count; i++) {
+        this->ids[i - 1]       = this->ids[i];
+        this->origin_x[i - 1]  = this->origin_x[i];
+        this->origin_y[i - 1]  = this->origin_y[i];
+        this->current_x[i - 1] = this->current_x[i];
+        this->current_y[i - 1] = this->current_y[i];
+    }
+
+    this->count--;
+}
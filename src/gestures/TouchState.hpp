@@ -0,0 +1,68 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <wayfire/touch/touch.hpp>
+
+// Fingers of the current touch sequence, replaces wf::touch::gesture_state_t.
+//
+// Positions are kept in fixed size arrays (one per coordinate) instead of a map of finger_t, so
+// walking all fingers reads a few contiguous arrays and never allocates. Fingers are ordered by
+// touch ID just like gesture_state_t::fingers, which keeps sums over them bit for bit the same.
+//
+// Touch downs past MAX_FINGERS are ignored, as are events of unknown touch IDs.
+class TouchState {
+  public:
+    static constexpr size_t MAX_FINGERS = 16;
+
+    void update(const wf::touch::gesture_event_t& event);
+
+    size_t size() const {
+        return this->count;
+    }
+
+    bool empty() const {
+        return this->count == 0;
+    }
+
+    // index of the finger with touch ID @id
+    std::optional<size_t> find(int id) const;
+
+    int id(size_t index) const {
+        return this->ids[index];
+    }
+
+    wf::touch::finger_t finger(size_t index) const {
+        return {
+            .origin  = {this->origin_x[index], this->origin_y[index]},
+            .current = {this->current_x[index], this->current_y[index]},
+        };
+    }
+
+    // only the first size() entries are meaningful
+    using Lane = std::array<double, MAX_FINGERS>;
+    const Lane& originX() const {
+        return this->origin_x;
+    }
+    const Lane& originY() const {
+        return this->origin_y;
+    }
+    const Lane& currentX() const {
+        return this->current_x;
+    }
+    const Lane& currentY() const {
+        return this->current_y;
+    }
+
+  private:
+    size_t count = 0;
+    std::array<int, MAX_FINGERS> ids;
+    alignas(32) Lane origin_x;
+    alignas(32) Lane origin_y;
+    alignas(32) Lane current_x;
+    alignas(32) Lane current_y;
+
+    void insert(size_t index, int id);
+    void erase(size_t index);
+};
@@ -7,11 +7,11 @@ void hyprgrass_debug(const std::string& s) {
     std::cout << "[debug] " << s << "\n";
 }
 
-bool CMockGestureManager::findCompletedGesture(const CompletedGestureEvent& gev) const {
-    return true;
+std::optional<BindHandle> CMockGestureManager::findCompletedGesture(const CompletedGestureEvent& gev) const {
+    return BindHandle{0};
 }
 
-bool CMockGestureManager::handleCompletedGesture(const CompletedGestureEvent& gev) {
+bool CMockGestureManager::handleCompletedGesture(const CompletedGestureEvent& gev, std::optional<BindHandle> binds) {
     std::cout << "gesture triggered: " << gev.to_string() << "\n";
     this->triggered = true;
     return true;
@@ -19,16 +19,21 @@ bool CMockGestureManager::handleCompletedGesture(const CompletedGestureEvent& ge
 
 bool CMockGestureManager::handleDragGesture(const DragGestureEvent& gev) {
     std::cout << "drag started: " << gev.to_string() << "\n";
+    if (this->handlesDragEvents) {
+        this->dragBegins++;
+    }
     return this->handlesDragEvents;
 }
 
 void CMockGestureManager::dragGestureUpdate(const wf::touch::gesture_event_t& gev) {
     std::cout << "drag update" << std::endl;
+    this->dragUpdates++;
 }
 
 void CMockGestureManager::handleDragGestureEnd(const DragGestureEvent& gev) {
     std::cout << "drag end: " << gev.to_string() << "\n";
     this->dragEnded = true;
+    this->dragEnds++;
 }
 
 void CMockGestureManager::handleCancelledGesture() {
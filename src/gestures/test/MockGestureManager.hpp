@@ -23,6 +23,10 @@ class CMockGestureManager final : public IGestureManager {
     bool cancelled        = false;
     bool dragEnded        = false;
     bool sentWindowCancel = false;
+    int dragUpdates       = 0;
+    // drags handled and ended over the whole test
+    int dragBegins = 0;
+    int dragEnds   = 0;
 
     struct {
         double x, y;
@@ -48,24 +52,22 @@ class CMockGestureManager final : public IGestureManager {
         dragEnded = false;
     }
 
-    auto getGestureAt(int index) const {
-        return &this->m_vGestures.at(index);
-    }
-
     wf::touch::point_t getLastPositionOfFinger(int id) {
-        auto pos = &this->m_sGestureState.fingers[id].current;
-        return {pos->x, pos->y};
+        return this->m_sGestureState.finger(this->m_sGestureState.find(id).value()).current;
     }
 
-    bool findCompletedGesture(const CompletedGestureEvent& gev) const override;
-    bool handleCompletedGesture(const CompletedGestureEvent& gev) override;
+    std::optional<BindHandle> findCompletedGesture(const CompletedGestureEvent& gev) const override;
+    bool handleCompletedGesture(const CompletedGestureEvent& gev, std::optional<BindHandle> binds) override;
     bool handleDragGesture(const DragGestureEvent& gev) override;
     void dragGestureUpdate(const wf::touch::gesture_event_t&) override;
     void handleDragGestureEnd(const DragGestureEvent& gev) override;
     void handleCancelledGesture() override;
 
-    void updateLongPressTimer(uint32_t current_time, uint32_t delay) override {}
-    void stopLongPressTimer() override {}
+    // deadline the gesture manager wants to be woken up at by onTimeout()
+    std::optional<uint32_t> armedDeadline;
+    void updateTimeoutTimer(uint32_t current_time, std::optional<uint32_t> deadline) override {
+        this->armedDeadline = deadline;
+    }
 
   protected:
     SMonitorArea getMonitorArea() const override {
@@ -0,0 +1,101 @@
+// Compares computing the per-event touch metrics from wf::touch::gesture_state_t (what the
+// recognizers used to do) to TouchState + TouchMetrics.
+//
+// run with `meson test --benchmark -v`
+#include "../TouchMetrics.hpp"
+#include "../TouchState.hpp"
+#include "wayfire/touch/touch.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <glm/glm.hpp>
+#include <vector>
+
+using Ev = wf::touch::gesture_event_t;
+
+constexpr int FRAMES = 2000;
+constexpr int ROUNDS = 50;
+
+// a swipe to the right with @fingers fingers, each frame moves every finger once
+static std::vector<Ev> swipe(int fingers) {
+    std::vector<Ev> events;
+    for (int f = 0; f < fingers; f++) {
+        events.push_back(Ev{wf::touch::EVENT_TYPE_TOUCH_DOWN, 0, f, {100.0 + f * 80, 500.0 + f * 3}});
+    }
+    for (int frame = 1; frame <= FRAMES; frame++) {
+        for (int f = 0; f < fingers; f++) {
+            const double x = 100.0 + f * 80 + frame * 0.5;
+            const double y = 500.0 + f * 3 + std::sin(frame * 0.1 + f) * 4;
+            events.push_back(Ev{wf::touch::EVENT_TYPE_MOTION, static_cast<uint32_t>(frame), f, {x, y}});
+        }
+    }
+    return events;
+}
+
+// everything TouchMetrics provides, computed the way the actions did before
+static double legacyMetrics(const wf::touch::gesture_state_t& state) {
+    const auto center = state.get_center();
+    double max_distance = 0.0, max_slip = 0.0, incorrect = 0.0;
+    glm::vec2 dev_sum = {};
+    for (const auto& [_, finger] : state.fingers) {
+        const auto delta = finger.delta();
+        max_distance     = std::max(max_distance, glm::length(delta));
+        max_slip         = std::max(max_slip, delta.x * delta.x + delta.y + delta.y);
+        incorrect        = std::max(incorrect, finger.get_incorrect_drag_distance(wf::touch::MOVE_DIRECTION_RIGHT));
+        dev_sum += glm::abs(finger.current - center.current);
+    }
+    const double span = std::hypot(dev_sum.x * 2 / state.fingers.size(), dev_sum.y * 2 / state.fingers.size());
+
+    return center.current.x + max_distance + max_slip + incorrect + span + state.get_pinch_scale() +
+        state.get_rotation_angle();
+}
+
+static double touchMetrics(const TouchMetrics& metrics) {
+    return metrics.center().current.x + metrics.maxFingerDistance() + metrics.maxTapSlip() +
+        metrics.maxIncorrectDragDistance(GESTURE_DIRECTION_RIGHT) + metrics.span() + metrics.pinchScale() +
+        metrics.rotation();
+}
+
+template <typename F>
+static double nsPerEvent(const std::vector<Ev>& events, F&& run) {
+    double best = 1e18;
+    for (int round = 0; round < ROUNDS; round++) {
+        const auto start = std::chrono::steady_clock::now();
+        run();
+        const auto end = std::chrono::steady_clock::now();
+        best           = std::min(best, std::chrono::duration<double, std::nano>(end - start).count());
+    }
+    return best / events.size();
+}
+
+int main() {
+    std::printf("fingers  gesture_state_t  TouchState  speedup\n");
+
+    volatile double sink = 0;
+    for (int fingers = 2; fingers <= 10; fingers++) {
+        const auto events = swipe(fingers);
+
+        const double legacy = nsPerEvent(events, [&] {
+            wf::touch::gesture_state_t state;
+            for (const auto& ev : events) {
+                state.update(ev);
+                sink = sink + legacyMetrics(state);
+            }
+        });
+
+        const double soa = nsPerEvent(events, [&] {
+            TouchState state;
+            TouchMetrics metrics;
+            for (const auto& ev : events) {
+                state.update(ev);
+                metrics.update(state);
+                sink = sink + touchMetrics(metrics);
+            }
+        });
+
+        std::printf("%7d  %12.1f ns  %7.1f ns  %6.2fx\n", fingers, legacy, soa, legacy / soa);
+    }
+
+    return 0;
+}
@@ -5,6 +5,11 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include <doctest/doctest.h>
 
+#include "../../ClientCache.hpp"
+#include "../GestureKey.hpp"
+#include "../TouchDevices.hpp"
+#include "../TouchMetrics.hpp"
+#include "../TouchState.hpp"
 #include "MockGestureManager.hpp"
 #include "wayfire/touch/touch.hpp"
 #include <vector>
@@ -36,7 +41,7 @@ struct ExpectResult {
     // variables below only used when type == CHECK_PROGRESS
     float progress = 0.0;
 
-    // which of the m_vGestures to use
+    // which of the recognizers to use
     // usually the first (0) in tests
     int gesture_index = 0;
 };
@@ -77,7 +82,7 @@ void checkCondition(CMockGestureManager& gm, ExpectResult expect) {
             CHECK(gm.sentWindowCancel);
             break;
         case ExpectResultType::CHECK_PROGRESS: {
-            const double got = gm.getGestureAt(expect.gesture_index)->get()->get_progress();
+            const double got = gm.getGestureProgress(expect.gesture_index);
             // fuck floating point math
             CHECK(std::abs(got - expect.progress) < 1e-5);
             break;
@@ -427,6 +432,31 @@ TEST_CASE("Edge Swipe Drag: emits drag end event") {
     ProcessEvents(gm, expected_result, events);
 }
 
+TEST_CASE("Edge Swipe Drag: consecutive swipes") {
+    log_start_of_test();
+    auto gm = CMockGestureManager::newDragHandler();
+    gm.addEdgeSwipeGesture(
+        SWIPE_THRESHOLD, SWIPE_INCORRECT_DRAG_TOLERANCE, &SENSITIVITY, &LONG_PRESS_DELAY, &EDGE_MARGIN
+    );
+
+    // the first swipe must not leave anything behind that stops the second one
+    for (uint32_t start : {100u, 1000u}) {
+        gm.resetTestResults();
+        gm.onTouchDown(Ev{wf::touch::EVENT_TYPE_TOUCH_DOWN, start, 0, {5, 300}});
+        gm.onTouchMove(Ev{wf::touch::EVENT_TYPE_MOTION, start + 50, 0, {250, 300}});
+        gm.onTouchMove(Ev{wf::touch::EVENT_TYPE_MOTION, start + 100, 0, {455, 300}});
+        REQUIRE(gm.getActiveDragGesture().has_value());
+        CHECK(gm.getActiveDragGesture()->type == GestureType::EDGE_SWIPE);
+
+        gm.onTouchUp(Ev{wf::touch::EVENT_TYPE_TOUCH_UP, start + 150, 0, {600, 300}});
+        CHECK(gm.dragEnded);
+        CHECK_FALSE(gm.getActiveDragGesture().has_value());
+    }
+
+    CHECK(gm.dragBegins == 2);
+    CHECK(gm.dragEnds == 2);
+}
+
 TEST_CASE("Edge Swipe: margins") {
     SUBCASE("custom margin: less than threshold triggers") {
         auto gm     = CMockGestureManager::newDragHandler();
@@ -599,3 +629,447 @@ TEST_CASE("Pinch out: completed gesture") {
 
     CHECK(gm.eventForwardingInhibited());
 }
+
+TEST_CASE("Parse gesture strings") {
+    const std::vector<CompletedGestureEvent> gestures{
+        {.type = GestureType::SWIPE, .direction = GESTURE_DIRECTION_LEFT, .finger_count = 3},
+        {.type = GestureType::SWIPE, .direction = GESTURE_DIRECTION_LEFT | GESTURE_DIRECTION_UP, .finger_count = 4},
+        {.type = GestureType::EDGE_SWIPE, .direction = GESTURE_DIRECTION_UP, .edge_origin = GESTURE_DIRECTION_DOWN},
+        {.type = GestureType::TAP, .finger_count = 3},
+        {.type = GestureType::LONG_PRESS, .finger_count = 1},
+        {.type = GestureType::PINCH, .direction = GESTURE_DIRECTION_OUT, .finger_count = 2},
+    };
+
+    for (const auto& gev : gestures) {
+        const auto parsed = parseCompletedGesture(gev.to_string());
+        CHECK(parsed.has_value());
+        CHECK(parsed == gev);
+    }
+
+    CHECK_FALSE(parseCompletedGesture("").has_value());
+    CHECK_FALSE(parseCompletedGesture("SUPER").has_value());
+    CHECK_FALSE(parseCompletedGesture("swipe:3").has_value());
+    CHECK_FALSE(parseCompletedGesture("swipe:x:l").has_value());
+    CHECK_FALSE(parseCompletedGesture("swipe:3:l:extra").has_value());
+    CHECK_FALSE(parseCompletedGesture("edge:d").has_value());
+    CHECK_FALSE(parseCompletedGesture("tap:3:l").has_value());
+}
+
+TEST_CASE("Gesture keys") {
+    constexpr auto SWIPE_KEY = GestureKey::make(GestureType::SWIPE, GESTURE_DIRECTION_LEFT, 3, 0);
+    static_assert(SWIPE_KEY.type() == GestureType::SWIPE);
+    static_assert(SWIPE_KEY.direction() == GESTURE_DIRECTION_LEFT);
+    static_assert(SWIPE_KEY.fingers() == 3);
+
+    CHECK(parseGestureKey("swipe:3:l") == SWIPE_KEY);
+    CHECK(
+        parseGestureKey("edge:d:u") ==
+        GestureKey::make(GestureType::EDGE_SWIPE, GESTURE_DIRECTION_UP, 0, GESTURE_DIRECTION_DOWN)
+    );
+    CHECK_FALSE(parseGestureKey("swipe:3").has_value());
+
+    // fields binds can't specify are ignored
+    const CompletedGestureEvent tap{.type = GestureType::TAP, .direction = GESTURE_DIRECTION_UP, .finger_count = 2};
+    CHECK(GestureKey::from(tap) == parseGestureKey("tap:2"));
+    const DragGestureEvent edge{
+        .type         = GestureType::EDGE_SWIPE,
+        .direction    = GESTURE_DIRECTION_RIGHT,
+        .finger_count = 1,
+        .edge_origin  = GESTURE_DIRECTION_LEFT,
+    };
+    CHECK(GestureKey::from(edge) == parseGestureKey("edge:l:r"));
+
+    for (const auto* s : {"swipe:4:lu", "edge:r:l", "tap:3", "longpress:1", "pinch:2:o"}) {
+        const auto key = parseGestureKey(s);
+        CHECK(key.has_value());
+        CHECK(key->to_string() == s);
+    }
+}
+
+TEST_CASE("Cancelled gestures are skipped until the next touch sequence") {
+    log_start_of_test();
+    auto gm = CMockGestureManager::newCompletedGestureOnlyHandler();
+    gm.addMultiFingerTap(SWIPE_INCORRECT_DRAG_TOLERANCE, &SENSITIVITY, &LONG_PRESS_DELAY);
+    gm.addMultiFingerGesture(SWIPE_THRESHOLD, SWIPE_INCORRECT_DRAG_TOLERANCE, &SENSITIVITY, &LONG_PRESS_DELAY);
+
+    gm.onTouchDown(Ev{wf::touch::EVENT_TYPE_TOUCH_DOWN, 100, 0, {450, 290}});
+    CHECK(gm.liveGestureCount() == 2);
+
+    // too far for a tap
+    gm.onTouchMove(Ev{wf::touch::EVENT_TYPE_MOTION, 150, 0, {550, 290}});
+    CHECK(gm.liveGestureCount() == 1);
+    CHECK(gm.getGestureStatus(0) == wf::touch::GESTURE_STATUS_CANCELLED);
+
+    gm.onTouchUp(Ev{wf::touch::EVENT_TYPE_TOUCH_UP, 200, 0, {550, 290}});
+    gm.resetTestResults();
+
+    gm.onTouchDown(Ev{wf::touch::EVENT_TYPE_TOUCH_DOWN, 300, 0, {450, 290}});
+    CHECK(gm.liveGestureCount() == 2);
+}
+
+TEST_CASE("Gestures without consumers are not recognized") {
+    log_start_of_test();
+    auto gm = CMockGestureManager::newCompletedGestureOnlyHandler();
+    gm.addMultiFingerTap(SWIPE_INCORRECT_DRAG_TOLERANCE, &SENSITIVITY, &LONG_PRESS_DELAY);
+    gm.addMultiFingerGesture(SWIPE_THRESHOLD, SWIPE_INCORRECT_DRAG_TOLERANCE, &SENSITIVITY, &LONG_PRESS_DELAY);
+
+    GestureDemand demand;
+    demand.add(GestureType::SWIPE, 3);
+    gm.setGestureDemand(demand);
+
+    gm.onTouchDown(Ev{wf::touch::EVENT_TYPE_TOUCH_DOWN, 100, 0, {450, 290}});
+    CHECK(gm.liveGestureCount() == 1);
+    gm.onTouchDown(Ev{wf::touch::EVENT_TYPE_TOUCH_DOWN, 110, 1, {500, 290}});
+    gm.onTouchDown(Ev{wf::touch::EVENT_TYPE_TOUCH_DOWN, 120, 2, {550, 290}});
+    CHECK(gm.liveGestureCount() == 1);
+
+    // nothing is bound to 4 finger swipes
+    gm.onTouchDown(Ev{wf::touch::EVENT_TYPE_TOUCH_DOWN, 130, 3, {600, 290}});
+    CHECK(gm.liveGestureCount() == 0);
+}
+
+TEST_CASE("Dropped gestures don't time out") {
+    log_start_of_test();
+    auto gm = CMockGestureManager::newDragHandler();
+    gm.addLongPress(SWIPE_THRESHOLD, &SENSITIVITY, &LONG_PRESS_DELAY);
+
+    GestureDemand demand;
+    demand.add(GestureType::LONG_PRESS, 2);
+    gm.setGestureDemand(demand);
+
+    gm.onTouchDown(Ev{wf::touch::EVENT_TYPE_TOUCH_DOWN, 100, 0, {450, 290}});
+    gm.onTouchDown(Ev{wf::touch::EVENT_TYPE_TOUCH_DOWN, 110, 1, {500, 290}});
+    REQUIRE(gm.armedDeadline.has_value());
+
+    // nothing is bound to 3 finger long presses
+    gm.onTouchDown(Ev{wf::touch::EVENT_TYPE_TOUCH_DOWN, 120, 2, {550, 290}});
+    CHECK(gm.liveGestureCount() == 0);
+    CHECK_FALSE(gm.armedDeadline.has_value());
+
+    gm.onTimeout(120 + LONG_PRESS_DELAY + 1);
+    CHECK_FALSE(gm.triggered);
+    CHECK_FALSE(gm.getActiveDragGesture().has_value());
+}
+
+TEST_CASE("Touch metrics match the finger state") {
+    wf::touch::gesture_state_t state;
+    TouchState touches;
+    for (const auto& ev : {
+             Ev{wf::touch::EVENT_TYPE_TOUCH_DOWN, 100, 1, {300, 100}},
+             Ev{wf::touch::EVENT_TYPE_TOUCH_DOWN, 100, 0, {100, 100}},
+             Ev{wf::touch::EVENT_TYPE_MOTION, 150, 0, {50, 120}},
+             Ev{wf::touch::EVENT_TYPE_MOTION, 150, 1, {350, 80}},
+         }) {
+        state.update(ev);
+        touches.update(ev);
+    }
+
+    TouchMetrics metrics;
+    metrics.update(touches);
+
+    CHECK(metrics.fingerCount() == 2);
+    CHECK(metrics.center().origin == state.get_center().origin);
+    CHECK(metrics.center().current == state.get_center().current);
+    CHECK(std::abs(metrics.pinchScale() - state.get_pinch_scale()) < 1e-9);
+    CHECK(std::abs(metrics.rotation() - state.get_rotation_angle()) < 1e-9);
+    CHECK(std::abs(metrics.maxFingerDistance() - std::hypot(50, 20)) < 1e-5);
+
+    const std::vector<GestureDirection> directions = {
+        GESTURE_DIRECTION_LEFT,
+        GESTURE_DIRECTION_UP | GESTURE_DIRECTION_RIGHT,
+    };
+    for (const auto direction : directions) {
+        double incorrect = 0;
+        for (const auto& [_, finger] : state.fingers) {
+            incorrect = std::max(incorrect, finger.get_incorrect_drag_distance(direction));
+        }
+        CHECK(std::abs(metrics.maxIncorrectDragDistance(direction) - incorrect) < 1e-9);
+        // cached
+        CHECK(std::abs(metrics.maxIncorrectDragDistance(direction) - incorrect) < 1e-9);
+    }
+
+    state.update(Ev{wf::touch::EVENT_TYPE_TOUCH_UP, 200, 0, {50, 120}});
+    touches.update(Ev{wf::touch::EVENT_TYPE_TOUCH_UP, 200, 0, {50, 120}});
+    metrics.update(touches);
+    CHECK(metrics.fingerCount() == 1);
+    CHECK(metrics.center().current == state.get_center().current);
+}
+
+TEST_CASE("Touch state keeps fingers ordered by ID and has a fixed capacity") {
+    TouchState touches;
+    for (int id : {5, 2, 9}) {
+        touches.update(Ev{wf::touch::EVENT_TYPE_TOUCH_DOWN, 100, id, {id * 10.0, 0}});
+    }
+
+    REQUIRE(touches.size() == 3);
+    CHECK(touches.id(0) == 2);
+    CHECK(touches.id(1) == 5);
+    CHECK(touches.id(2) == 9);
+    CHECK(touches.finger(1).origin == point_t{50, 0});
+
+    touches.update(Ev{wf::touch::EVENT_TYPE_MOTION, 110, 5, {60, 10}});
+    touches.update(Ev{wf::touch::EVENT_TYPE_TOUCH_UP, 120, 2, {20, 0}});
+    REQUIRE(touches.size() == 2);
+    CHECK(touches.id(0) == 5);
+    CHECK(touches.finger(0).origin == point_t{50, 0});
+    CHECK(touches.finger(0).current == point_t{60, 10});
+
+    // events of unknown fingers are ignored
+    touches.update(Ev{wf::touch::EVENT_TYPE_MOTION, 130, 42, {0, 0}});
+    CHECK(touches.size() == 2);
+
+    for (int id = 100; id < 100 + (int)TouchState::MAX_FINGERS; id++) {
+        touches.update(Ev{wf::touch::EVENT_TYPE_TOUCH_DOWN, 140, id, {0, 0}});
+    }
+    CHECK(touches.size() == TouchState::MAX_FINGERS);
+    CHECK_FALSE(touches.find(100 + TouchState::MAX_FINGERS - 1).has_value());
+}
+
+TEST_CASE("Swipe Drag: queued motion is processed once per frame") {
+    log_start_of_test();
+    auto gm = CMockGestureManager::newDragHandler();
+    gm.addMultiFingerGesture(SWIPE_THRESHOLD, SWIPE_INCORRECT_DRAG_TOLERANCE, &SENSITIVITY, &LONG_PRESS_DELAY);
+
+    gm.onTouchDown(Ev{wf::touch::EVENT_TYPE_TOUCH_DOWN, 100, 0, {450, 290}});
+    gm.onTouchDown(Ev{wf::touch::EVENT_TYPE_TOUCH_DOWN, 100, 1, {500, 300}});
+    gm.onTouchDown(Ev{wf::touch::EVENT_TYPE_TOUCH_DOWN, 100, 2, {550, 290}});
+
+    // every finger moves down, on its own the first one would be moving way off the
+    // direction of the others
+    for (int frame = 1; frame <= 10; frame++) {
+        const uint32_t time = 100 + frame * 10;
+        const double dy     = frame * 20.0;
+        gm.queueMotion(Ev{wf::touch::EVENT_TYPE_MOTION, time, 0, {450, 290 + dy}});
+        gm.queueMotion(Ev{wf::touch::EVENT_TYPE_MOTION, time, 1, {500, 300 + dy}});
+        gm.queueMotion(Ev{wf::touch::EVENT_TYPE_MOTION, time, 2, {550, 290 + dy}});
+        CHECK(gm.hasQueuedMotion());
+        gm.flushMotion();
+        CHECK_FALSE(gm.hasQueuedMotion());
+    }
+
+    REQUIRE(gm.getActiveDragGesture().has_value());
+    CHECK(gm.getActiveDragGesture()->direction == GESTURE_DIRECTION_DOWN);
+    CHECK(gm.getLastPositionOfFinger(0) == point_t{450, 490});
+
+    const int updates = gm.dragUpdates;
+    gm.queueMotion(Ev{wf::touch::EVENT_TYPE_MOTION, 300, 0, {450, 520}});
+    gm.queueMotion(Ev{wf::touch::EVENT_TYPE_MOTION, 300, 1, {500, 530}});
+    gm.queueMotion(Ev{wf::touch::EVENT_TYPE_MOTION, 300, 2, {550, 520}});
+    CHECK(gm.dragUpdates == updates);
+
+    // touch events flush the queue first, the lift itself ends the drag
+    gm.onTouchUp(Ev{wf::touch::EVENT_TYPE_TOUCH_UP, 310, 0, {450, 520}});
+    CHECK(gm.dragUpdates == updates + 1);
+    CHECK(gm.dragEnded);
+}
+
+TEST_CASE("Sessions of different devices don't interfere") {
+    log_start_of_test();
+    auto gm = CMockGestureManager::newDragHandler();
+    gm.addMultiFingerGesture(SWIPE_THRESHOLD, SWIPE_INCORRECT_DRAG_TOLERANCE, &SENSITIVITY, &LONG_PRESS_DELAY);
+    auto other = gm.newSession();
+
+    gm.onTouchDown(Ev{wf::touch::EVENT_TYPE_TOUCH_DOWN, 100, 0, {450, 290}});
+    gm.onTouchDown(Ev{wf::touch::EVENT_TYPE_TOUCH_DOWN, 100, 1, {500, 300}});
+    gm.onTouchDown(Ev{wf::touch::EVENT_TYPE_TOUCH_DOWN, 100, 2, {550, 290}});
+
+    // a second panel reuses the same touch IDs and would cancel the swipe by moving them elsewhere
+    gm.swapSession(other);
+    gm.onTouchDown(Ev{wf::touch::EVENT_TYPE_TOUCH_DOWN, 110, 0, {1500, 900}});
+    gm.onTouchDown(Ev{wf::touch::EVENT_TYPE_TOUCH_DOWN, 110, 1, {1600, 900}});
+    gm.onTouchMove(Ev{wf::touch::EVENT_TYPE_MOTION, 120, 0, {1500, 890}});
+    CHECK(gm.getLastPositionOfFinger(0) == point_t{1500, 890});
+
+    gm.swapSession(other);
+    CHECK(gm.getLastPositionOfFinger(0) == point_t{450, 290});
+    gm.onTouchMove(Ev{wf::touch::EVENT_TYPE_MOTION, 200, 0, {0, 290}});
+    REQUIRE(gm.getActiveDragGesture().has_value());
+    CHECK(gm.getActiveDragGesture()->finger_count == 3);
+
+    // the drag belongs to the first session only
+    gm.swapSession(other);
+    CHECK_FALSE(gm.getActiveDragGesture().has_value());
+}
+
+TEST_CASE("Touch devices: the same touch IDs on two devices") {
+    log_start_of_test();
+    constexpr int PANEL_A = 1, PANEL_B = 2;
+
+    SUBCASE("hints arrive before the events") {
+        TouchDevices<int> devices;
+        devices.hint(PANEL_A, 0, 100);
+        devices.down(PANEL_A, 0, 100);
+        devices.hint(PANEL_B, 0, 110);
+        devices.down(PANEL_B, 0, 110);
+        CHECK(devices.isDown(PANEL_A, 0));
+        CHECK(devices.isDown(PANEL_B, 0));
+
+        devices.hint(PANEL_A, 0, 120);
+        CHECK(devices.resolve(0, 120) == PANEL_A);
+
+        // panel B lifting its finger leaves the one of panel A down
+        devices.hint(PANEL_B, 0, 130);
+        REQUIRE(devices.resolve(0, 130) == PANEL_B);
+        devices.up(PANEL_B, 0);
+        CHECK(devices.isDown(PANEL_A, 0));
+
+        devices.hint(PANEL_A, 0, 140);
+        CHECK(devices.resolve(0, 140) == PANEL_A);
+    }
+
+    SUBCASE("hints arrive after the events") {
+        TouchDevices<int> devices;
+        devices.down(PANEL_A, 0, 100);
+        devices.hint(PANEL_A, 0, 100);
+        devices.down(PANEL_B, 0, 110);
+        devices.hint(PANEL_B, 0, 110);
+
+        // the hint left over from panel B's event is not trusted
+        CHECK(devices.resolve(0, 110) == PANEL_B);
+        CHECK(devices.isDown(PANEL_A, 0));
+        CHECK(devices.isDown(PANEL_B, 0));
+    }
+
+    SUBCASE("unknown touch points") {
+        TouchDevices<int> devices;
+        CHECK_FALSE(devices.resolve(0, 100).has_value());
+    }
+}
+
+TEST_CASE("Client cache: rebuilt when a client binds another touch") {
+    log_start_of_test();
+    struct Entry {
+        size_t bound = 0;
+        std::vector<int> touches;
+    };
+    // touches bound by each client, like the wl_touch resources of its seat
+    std::vector<std::vector<int>> seats = {{10}, {}};
+    int builds                          = 0;
+
+    ClientCache<int, Entry> cache;
+    const auto outdated = [&](const Entry& entry) { return seats[0].size() > entry.bound; };
+    const auto build    = [&](int client, Entry& entry) {
+        builds++;
+        entry.bound   = seats[client].size();
+        entry.touches = seats[client];
+        return !entry.touches.empty();
+    };
+
+    REQUIRE(cache.get(0, outdated, build) != nullptr);
+    CHECK(cache.get(0, outdated, build)->touches.size() == 1);
+    CHECK(builds == 1);
+
+    // a second wl_touch next to the first one
+    seats[0].push_back(11);
+    const auto* entry = cache.get(0, outdated, build);
+    REQUIRE(entry != nullptr);
+    CHECK(entry->touches == std::vector<int>{10, 11});
+    CHECK(builds == 2);
+
+    // one of them destroyed
+    cache.drop(0);
+    seats[0] = {11};
+    REQUIRE(cache.get(0, outdated, build) != nullptr);
+    CHECK(cache.find(0)->touches == std::vector<int>{11});
+    CHECK(builds == 3);
+
+    // clients without touches are not cached
+    CHECK(cache.get(1, outdated, build) == nullptr);
+    CHECK(cache.find(1) == nullptr);
+    CHECK(cache.size() == 1);
+}
+
+TEST_CASE("Parked sessions adopt rebuilt recognizers") {
+    log_start_of_test();
+    auto gm = CMockGestureManager::newDragHandler();
+    gm.addMultiFingerGesture(SWIPE_THRESHOLD, SWIPE_INCORRECT_DRAG_TOLERANCE, &SENSITIVITY, &LONG_PRESS_DELAY);
+    auto other = gm.newSession();
+
+    // e.g. a config reload while the other device is parked
+    gm.clearRecognizers();
+    gm.addLongPress(SWIPE_THRESHOLD, &SENSITIVITY, &LONG_PRESS_DELAY);
+    gm.adoptRecognizers(other);
+    gm.swapSession(other);
+
+    gm.onTouchDown(Ev{wf::touch::EVENT_TYPE_TOUCH_DOWN, 100, 0, {450, 290}});
+    gm.onTimeout(100 + LONG_PRESS_DELAY + 1);
+    checkCondition(gm, {.type = ExpectResultType::DRAG_TRIGGERED});
+}
+
+TEST_CASE("Long press: completes on timeout without further events") {
+    log_start_of_test();
+    auto gm = CMockGestureManager::newDragHandler();
+    gm.addLongPress(SWIPE_THRESHOLD, &SENSITIVITY, &LONG_PRESS_DELAY);
+
+    gm.onTouchDown(Ev{wf::touch::EVENT_TYPE_TOUCH_DOWN, 100, 0, {450, 290}});
+    CHECK(gm.armedDeadline == 100 + LONG_PRESS_DELAY + 1);
+    // every touch down restarts the press
+    gm.onTouchDown(Ev{wf::touch::EVENT_TYPE_TOUCH_DOWN, 110, 1, {500, 300}});
+    CHECK(gm.armedDeadline == 110 + LONG_PRESS_DELAY + 1);
+
+    // a timer that fires too early does nothing
+    gm.onTimeout(300);
+    CHECK_FALSE(gm.getActiveDragGesture().has_value());
+
+    gm.onTimeout(110 + LONG_PRESS_DELAY + 1);
+    checkCondition(gm, {.type = ExpectResultType::DRAG_TRIGGERED});
+    CHECK_FALSE(gm.armedDeadline.has_value());
+}
+
+TEST_CASE("Swipe: cancelled on timeout without further events") {
+    log_start_of_test();
+    auto gm = CMockGestureManager::newDragHandler();
+    gm.addMultiFingerGesture(SWIPE_THRESHOLD, SWIPE_INCORRECT_DRAG_TOLERANCE, &SENSITIVITY, &LONG_PRESS_DELAY);
+
+    gm.onTouchDown(Ev{wf::touch::EVENT_TYPE_TOUCH_DOWN, 100, 0, {450, 290}});
+    gm.onTouchDown(Ev{wf::touch::EVENT_TYPE_TOUCH_DOWN, 100, 1, {500, 300}});
+    REQUIRE(gm.armedDeadline.has_value());
+
+    CHECK(gm.hasLiveGesture(GestureType::SWIPE));
+
+    gm.onTimeout(*gm.armedDeadline);
+    CHECK(gm.cancelled);
+    CHECK(gm.getGestureStatus(0) == wf::touch::GESTURE_STATUS_CANCELLED);
+    CHECK_FALSE(gm.armedDeadline.has_value());
+    // the fingers are still down, but nothing can turn into a swipe anymore
+    CHECK_FALSE(gm.hasLiveGesture(GestureType::SWIPE));
+}
+
+TEST_CASE("Touch history: velocity of fingers and their centroid") {
+    log_start_of_test();
+    auto gm = CMockGestureManager::newDragHandler();
+    auto close = [](point_t a, point_t b) { return std::abs(a.x - b.x) < 1e-5 && std::abs(a.y - b.y) < 1e-5; };
+
+    gm.onTouchDown(Ev{wf::touch::EVENT_TYPE_TOUCH_DOWN, 100, 0, {100, 100}});
+    gm.onTouchDown(Ev{wf::touch::EVENT_TYPE_TOUCH_DOWN, 100, 1, {200, 100}});
+    CHECK(close(gm.touchHistory().centerVelocity(), {0, 0}));
+
+    // finger 0 moves right at 1000px/s, finger 1 follows in the same frame
+    for (uint32_t t = 110; t <= 200; t += 10) {
+        gm.queueMotion(Ev{wf::touch::EVENT_TYPE_MOTION, t, 0, {100 + (t - 100.0), 100}});
+        gm.queueMotion(Ev{wf::touch::EVENT_TYPE_MOTION, t, 1, {200 + (t - 100.0), 100}});
+        gm.flushMotion();
+    }
+    CHECK(close(*gm.touchHistory().fingerVelocity(0), {1000, 0}));
+    CHECK(close(gm.touchHistory().centerVelocity(), {1000, 0}));
+    // one sample per frame, after the one of the second touch down
+    CHECK(gm.touchHistory().center().size() == 11);
+
+    // the velocity at release is still there after a finger lifts
+    gm.onTouchUp(Ev{wf::touch::EVENT_TYPE_TOUCH_UP, 210, 1, {300, 100}});
+    CHECK_FALSE(gm.touchHistory().fingerVelocity(1).has_value());
+    CHECK(close(gm.touchHistory().centerVelocity(), {1000, 0}));
+
+    // samples older than the horizon don't count, finger 0 now moves down at 500px/s
+    for (uint32_t t = 220; t <= 400; t += 20) {
+        gm.onTouchMove(Ev{wf::touch::EVENT_TYPE_MOTION, t, 0, {200, 100 + (t - 220) / 2.0}});
+    }
+    CHECK(close(*gm.touchHistory().fingerVelocity(0), {0, 500}));
+    // the centroid jumped when the finger lifted, its history starts over with the next motion
+    CHECK(close(gm.touchHistory().centerVelocity(), {0, 500}));
+
+    // a long pause means the finger stopped
+    gm.onTouchMove(Ev{wf::touch::EVENT_TYPE_MOTION, 500, 0, {200, 200}});
+    CHECK(gm.touchHistory().finger(0)->size() == 1);
+    CHECK(close(*gm.touchHistory().fingerVelocity(0), {0, 0}));
+}
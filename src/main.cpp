@@ -3,6 +3,7 @@
 #include "TouchVisualizer.hpp"
 #include "gestures/CompletedGesture.hpp"
 #include "gestures/DragGesture.hpp"
+#include "gestures/GestureKey.hpp"
 #include "globals.hpp"
 #include "version.hpp"
 
@@ -29,6 +30,7 @@
 #include <hyprland/src/managers/input/trackpad/gestures/SpecialWorkspaceGesture.hpp>
 #include <hyprland/src/managers/input/trackpad/gestures/WorkspaceSwipeGesture.hpp>
 #include <hyprland/src/plugins/PluginAPI.hpp>
+#include <hyprland/src/render/Renderer.hpp>
 #include <hyprland/src/version.h>
 
 #include <hyprlang.hpp>
@@ -61,18 +63,58 @@ inline std::unique_ptr<Visualizer> g_pVisualizer;
 
 static bool g_unloading = false;
 
+static bool visualizerEnabled() {
+    static auto const VISUALIZE = g_config->visualizeTouches;
+    return g_pVisualizer && VISUALIZE->value();
+}
+
+// held touches replayed by the gesture manager were drawn when they first came in
+static bool visualizeTouchEvent() {
+    return visualizerEnabled() && !g_pGestureManager->isReplayingHeld();
+}
+
 void hkOnTouchDown(ITouch::SDownEvent ev, Event::SCallbackInfo& cbinfo) {
+    if (visualizeTouchEvent()) {
+        g_pVisualizer->onTouchDown(ev);
+    }
     cbinfo.cancelled = g_pGestureManager->onTouchDown(ev);
 }
 
+// up and motion events don't carry their device, the gesture manager finds it from the hints the device leaves
+// before the event, see TouchDevices. Runs before the gesture manager forgets the touch point on touch up
 void hkOnTouchUp(ITouch::SUpEvent ev, Event::SCallbackInfo& cbinfo) {
+    if (visualizeTouchEvent()) {
+        g_pVisualizer->onTouchUp(ev, g_pGestureManager->deviceOfTouch(ev.touchID, ev.timeMs));
+    }
     cbinfo.cancelled = g_pGestureManager->onTouchUp(ev);
 }
 
 void hkOnTouchMove(ITouch::SMotionEvent ev, Event::SCallbackInfo& cbinfo) {
+    if (visualizeTouchEvent()) {
+        g_pVisualizer->onTouchMotion(ev, g_pGestureManager->deviceOfTouch(ev.touchID, ev.timeMs));
+    }
     cbinfo.cancelled = g_pGestureManager->onTouchMove(ev);
 }
 
+void hkOnPreRender(PHLMONITOR monitor) {
+    if (g_pGestureManager) {
+        g_pGestureManager->onPreRender(monitor);
+    }
+    if (visualizerEnabled()) {
+        g_pVisualizer->onPreRender(monitor);
+    }
+}
+
+void hkOnRenderStage(eRenderStage stage) {
+    if (stage != RENDER_LAST_MOMENT || !visualizerEnabled()) {
+        return;
+    }
+
+    if (const auto monitor = Render::GL::g_pHyprOpenGL->m_renderData.pMonitor.lock()) {
+        g_pVisualizer->onRender(monitor);
+    }
+}
+
 static Hyprlang::CParseResult hyprgrassGestureKeyword(const char* LHS, const char* RHS) {
     Hyprlang::CParseResult result;
 
@@ -212,6 +254,8 @@ static Hyprlang::CParseResult hyprgrassGestureKeyword(const char* LHS, const cha
         return result;
     }
 
+    g_pShimTrackpadGestures->invalidate();
+
     if (!resultFromGesture) {
         result.setError(resultFromGesture.error().c_str());
         return result;
@@ -290,6 +334,7 @@ int newBind(lua_State* L) {
         );
 
     SKeybind bind{};
+    GestureKey gesture;
 
     // Parse the table structure
     {
@@ -311,7 +356,14 @@ int newBind(lua_State* L) {
         lua_getfield(L, 1, "pattern");
 
         if (lua_isstring(L, 2)) {
-            bind.key = lua_tostring(L, 2);
+            bind.key          = lua_tostring(L, 2);
+            const auto parsed = parseGestureKey(bind.key);
+            if (!parsed) {
+                return Config::Lua::Bindings::Internal::configError(
+                    L, std::format("hyprgrass.bind: invalid gesture in field \"pattern\": {}", bind.key)
+                );
+            }
+            gesture = *parsed;
         } else {
             auto maybeGesture = gestureConfigFromTable(L, 2, false);
             if (!maybeGesture) {
@@ -319,7 +371,8 @@ int newBind(lua_State* L) {
                     L, std::format("hyprgrass.bind: in field \"pattern\": {}", maybeGesture.error())
                 );
             }
-            bind.key = maybeGesture.value().to_string();
+            gesture  = maybeGesture.value().key();
+            bind.key = gesture.to_string();
         }
 
         // TODO: idk what this is
@@ -340,7 +393,7 @@ int newBind(lua_State* L) {
     bind.mouse  = luaTableGetBool(L, 1, "mouse");
     bind.locked = luaTableGetBool(L, 1, "locked");
 
-    g_pGestureManager->internalBinds.emplace_back(makeShared<SKeybind>(bind));
+    g_pGestureManager->addInternalBind(gesture, makeShared<SKeybind>(bind));
 
     return 0;
 }
@@ -623,6 +676,8 @@ int newGesture(lua_State* L) {
             );
     }
 
+    g_pShimTrackpadGestures->invalidate();
+
     if (!result) {
         return Config::Lua::Bindings::Internal::configError(L, result.error());
     }
@@ -630,13 +685,16 @@ int newGesture(lua_State* L) {
 }
 
 static void onPreConfigReload() {
-    if (g_pGestureManager)
-        g_pGestureManager->internalBinds.clear();
+    if (g_pGestureManager) {
+        g_pGestureManager->clearInternalBinds();
+        g_pGestureManager->invalidateGestureDemand();
+    }
 
     if (g_pShimTrackpadGestures) {
         for (auto& g : g_pShimTrackpadGestures->gestures) {
             g.clearGestures();
         }
+        g_pShimTrackpadGestures->invalidate();
     }
 }
 
@@ -647,8 +705,8 @@ SDispatchResult listInternalBinds(std::string) {
         GestureType::EDGE_SWIPE,
     };
     Log::logger->log(Log::DEBUG, "[hyprgrass] Listing internal binds:");
-    for (const auto& bind : g_pGestureManager->internalBinds) {
-        Log::logger->log(Log::DEBUG, "[hyprgrass] | gesture: {}", bind->key);
+    for (const auto& [gesture, bind] : g_pGestureManager->internalBinds) {
+        Log::logger->log(Log::DEBUG, "[hyprgrass] | gesture: {}", gesture);
         Log::logger->log(Log::DEBUG, "[hyprgrass] |     dispatcher: {}", bind->handler);
         Log::logger->log(Log::DEBUG, "[hyprgrass] |     arg: {}", bind->arg);
         Log::logger->log(Log::DEBUG, "[hyprgrass] |     mouse: {}", bind->mouse);
@@ -710,15 +768,21 @@ Hyprlang::CParseResult hyrgrassBindKeyword(const char* K, const char* V) {
     const auto dispatcher     = flags.mouse ? "mouse" : vars[2];
     const auto dispatcherArgs = flags.mouse ? vars[2] : vars[3];
 
-    g_pGestureManager->internalBinds.emplace_back(
-        makeShared<SKeybind>(SKeybind{
-            .key     = key,
-            .modmask = modMask,
-            .handler = dispatcher,
-            .arg     = dispatcherArgs,
-            .locked  = flags.locked,
-            .mouse   = flags.mouse,
-        })
+    const auto gesture = parseGestureKey(key);
+    if (!gesture) {
+        result.setError(std::format("invalid gesture: {}", key).c_str());
+        return result;
+    }
+
+    g_pGestureManager->addInternalBind(
+        *gesture, makeShared<SKeybind>(SKeybind{
+                      .key     = key,
+                      .modmask = modMask,
+                      .handler = dispatcher,
+                      .arg     = dispatcherArgs,
+                      .locked  = flags.locked,
+                      .mouse   = flags.mouse,
+                  })
     );
 
     return result;
@@ -770,8 +834,20 @@ APICALL EXPORT PLUGIN_DESCRIPTION_INFO PLUGIN_INIT(HANDLE handle) {
     HyprlandAPI::addConfigValueV2(PHANDLE, g_config->sensitivity);
     HyprlandAPI::addConfigValueV2(PHANDLE, g_config->sendCancel);
     HyprlandAPI::addConfigValueV2(PHANDLE, g_config->resizeOnBorder);
+    HyprlandAPI::addConfigValueV2(PHANDLE, g_config->batchMotion);
+    HyprlandAPI::addConfigValueV2(PHANDLE, g_config->workspaceSwipeWarmup);
+    HyprlandAPI::addConfigValueV2(PHANDLE, g_config->holdWindow);
+    HyprlandAPI::addConfigValueV2(PHANDLE, g_config->workspaceSwipeFlingVelocity);
+    HyprlandAPI::addConfigValueV2(PHANDLE, g_config->visualizeTouches);
+    HyprlandAPI::addConfigValueV2(PHANDLE, g_config->visualizerTrail);
 
     static auto P0 = Event::bus()->m_events.config.preReload.listen([&] { onPreConfigReload(); });
+    // also emitted after `hyprctl keyword`, e.g. for binds added or removed at runtime
+    static auto P6 = Event::bus()->m_events.config.reloaded.listen([&] {
+        if (g_pGestureManager) {
+            g_pGestureManager->onConfigReloaded();
+        }
+    });
 
     HyprlandAPI::addDispatcherV2(PHANDLE, "touchBind", [&](std::string args) {
         HyprlandAPI::addNotification(
@@ -801,11 +877,14 @@ APICALL EXPORT PLUGIN_DESCRIPTION_INFO PLUGIN_INIT(HANDLE handle) {
     static auto P1 = Event::bus()->m_events.input.touch.down.listen(hkOnTouchDown);
     static auto P2 = Event::bus()->m_events.input.touch.up.listen(hkOnTouchUp);
     static auto P3 = Event::bus()->m_events.input.touch.motion.listen(hkOnTouchMove);
+    static auto P4 = Event::bus()->m_events.render.pre.listen(hkOnPreRender);
+    static auto P5 = Event::bus()->m_events.render.stage.listen(hkOnRenderStage);
 
     HyprlandAPI::reloadConfig();
 
     g_pGestureManager       = std::make_unique<GestureManager>();
     g_pShimTrackpadGestures = std::make_unique<ShimTrackpadGestures>();
+    g_pVisualizer           = std::make_unique<Visualizer>();
 
     return {"hyprgrass", "Touchscreen gestures", "horriblename", HYPRGRASS_VERSION};
 }